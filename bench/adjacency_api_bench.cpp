@@ -0,0 +1,180 @@
+// Whole-mesh analyses written three ways: with the vector-returning
+// adjacency queries, with the visitor templates and with fixed-capacity
+// stack buffers. Reports time and heap allocations for each and checks
+// that all three give the same answers.
+//
+// Usage: adjacency_api_bench [file.obj] [--levels N] [--runs N]
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "half_edge.hpp"
+
+// Count every heap allocation made by the process
+static std::atomic<size_t> g_allocations{0};
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+const size_t kMaxValence = 32; // Histogram bins; higher valences land in the last bin
+
+struct Analysis {
+    std::vector<size_t> valence = std::vector<size_t>(kMaxValence, 0);
+    size_t faceNeighbours = 0;  // Sum over faces of adjacent faces
+    size_t boundaryEdges = 0;   // Half-edges with a single face
+    size_t boundaryLoops = 0;
+    size_t boundaryLength = 0;  // Half-edges over all traced loops
+
+    bool operator==(const Analysis& o) const {
+        return valence == o.valence && faceNeighbours == o.faceNeighbours && boundaryEdges == o.boundaryEdges &&
+               boundaryLoops == o.boundaryLoops && boundaryLength == o.boundaryLength;
+    }
+};
+
+// A neighbour of v is reached by each outgoing half-edge, plus one
+// incoming boundary half-edge on an open fan
+size_t valenceContribution(const HalfEdgeMesh& mesh, HEIndex v, HEIndex he) {
+    return mesh.origin[he] == v || mesh.twin[he] == HE_INVALID;
+}
+
+void addValence(Analysis& a, size_t valence) {
+    ++a.valence[std::min(valence, kMaxValence - 1)];
+}
+
+// Trace every boundary loop once; visited is sized by the caller
+template <class NextBoundary>
+void traceBoundaryLoops(const HalfEdgeMesh& mesh, std::vector<char>& visited, Analysis& a, NextBoundary&& nextBoundary) {
+    std::fill(visited.begin(), visited.end(), 0);
+    for (HEIndex h = 0; h < mesh.halfEdgeCount(); ++h) {
+        if (mesh.twin[h] != HE_INVALID || visited[h]) continue;
+        ++a.boundaryLoops;
+        for (HEIndex cur = h; cur != HE_INVALID && !visited[cur]; cur = nextBoundary(cur)) {
+            visited[cur] = 1;
+            ++a.boundaryLength;
+        }
+    }
+}
+
+void analyseWithVectors(const HalfEdgeMesh& mesh, std::vector<char>& visited, Analysis& a) {
+    for (HEIndex v = 0; v < mesh.vertexCount(); ++v) {
+        size_t valence = 0;
+        for (HEIndex he : getEdgesOfVertex(mesh, v)) valence += valenceContribution(mesh, v, he);
+        addValence(a, valence);
+    }
+    for (HEIndex f = 0; f < mesh.faceCount(); ++f) a.faceNeighbours += getAdjacentFacesOfFace(mesh, f).size();
+    for (HEIndex h = 0; h < mesh.halfEdgeCount(); ++h) a.boundaryEdges += getAdjacentFacesOfEdge(mesh, h).size() == 1;
+    traceBoundaryLoops(mesh, visited, a, [&](HEIndex h) {
+        const HEIndex v = mesh.dest(h);
+        for (HEIndex he : getEdgesOfVertex(mesh, v)) {
+            if (mesh.origin[he] == v && mesh.twin[he] == HE_INVALID) return he;
+        }
+        return HE_INVALID;
+    });
+}
+
+void analyseWithVisitors(const HalfEdgeMesh& mesh, std::vector<char>& visited, Analysis& a) {
+    for (HEIndex v = 0; v < mesh.vertexCount(); ++v) {
+        size_t valence = 0;
+        forEachEdgeOfVertex(mesh, v, [&](HEIndex he) { valence += valenceContribution(mesh, v, he); });
+        addValence(a, valence);
+    }
+    for (HEIndex f = 0; f < mesh.faceCount(); ++f) forEachAdjacentFaceOfFace(mesh, f, [&](HEIndex) { ++a.faceNeighbours; });
+    for (HEIndex h = 0; h < mesh.halfEdgeCount(); ++h) {
+        size_t faces = 0;
+        forEachFaceOfEdge(mesh, h, [&](HEIndex) { ++faces; });
+        a.boundaryEdges += faces == 1;
+    }
+    traceBoundaryLoops(mesh, visited, a, [&](HEIndex h) { return nextBoundaryHalfEdge(mesh, h); });
+}
+
+void analyseWithBuffers(const HalfEdgeMesh& mesh, std::vector<char>& visited, Analysis& a) {
+    FixedIndexBuffer<64> buffer;
+    for (HEIndex v = 0; v < mesh.vertexCount(); ++v) {
+        size_t valence = 0;
+        if (getEdgesOfVertex(mesh, v, buffer)) {
+            for (HEIndex he : buffer) valence += valenceContribution(mesh, v, he);
+        } else {
+            for (HEIndex he : getEdgesOfVertex(mesh, v)) valence += valenceContribution(mesh, v, he);
+        }
+        addValence(a, valence);
+    }
+    for (HEIndex f = 0; f < mesh.faceCount(); ++f) {
+        getAdjacentFacesOfFace(mesh, f, buffer);
+        a.faceNeighbours += buffer.count;
+    }
+    for (HEIndex h = 0; h < mesh.halfEdgeCount(); ++h) {
+        getAdjacentFacesOfEdge(mesh, h, buffer);
+        a.boundaryEdges += buffer.count == 1;
+    }
+    traceBoundaryLoops(mesh, visited, a, [&](HEIndex h) {
+        const HEIndex v = mesh.dest(h);
+        if (!getEdgesOfVertex(mesh, v, buffer)) return nextBoundaryHalfEdge(mesh, h);
+        for (HEIndex he : buffer) {
+            if (mesh.origin[he] == v && mesh.twin[he] == HE_INVALID) return he;
+        }
+        return HE_INVALID;
+    });
+}
+
+template <class F>
+void measure(const char* label, int runs, const HalfEdgeMesh& mesh, F&& analyse, Analysis& result) {
+    std::vector<char> visited(mesh.halfEdgeCount());
+    double best = 1e30;
+    size_t allocations = 0;
+    for (int r = 0; r < runs; ++r) {
+        result = Analysis();
+        const size_t before = g_allocations.load();
+        auto start = bench::Clock::now();
+        analyse(mesh, visited, result);
+        best = std::min(best, bench::secondsSince(start));
+        allocations = g_allocations.load() - before;
+    }
+    std::printf("%-10s %9.2f ms  %10zu allocations\n", label, best * 1000.0, allocations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 3;
+    int runs = 3;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    ObjMeshData data;
+    if (!bench::loadSubdivided(input, levels, data)) return 1;
+    HalfEdgeMesh mesh;
+    buildHalfEdgeMeshFromPointsAndFaces(data.points, data.faces, mesh);
+    std::printf("%s subdivided %d times: %zu vertices, %zu faces, %zu half-edges\n", input.c_str(), levels,
+                mesh.vertexCount(), mesh.faceCount(), mesh.halfEdgeCount());
+
+    Analysis vectors, visitors, buffers;
+    measure("vectors", runs, mesh, analyseWithVectors, vectors);
+    measure("visitors", runs, mesh, analyseWithVisitors, visitors);
+    measure("buffers", runs, mesh, analyseWithBuffers, buffers);
+
+    std::printf("boundary: %zu half-edges in %zu loops (%zu traced); valence:", vectors.boundaryEdges,
+                vectors.boundaryLoops, vectors.boundaryLength);
+    for (size_t k = 0; k < kMaxValence; ++k) {
+        if (vectors.valence[k]) std::printf(" %zu:%zu", k, vectors.valence[k]);
+    }
+    const bool same = vectors == visitors && vectors == buffers;
+    std::printf("\nresults: %s\n", same ? "identical" : "MISMATCH");
+    return same ? 0 : 1;
+}
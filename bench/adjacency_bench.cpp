@@ -0,0 +1,94 @@
+// Vertex adjacency queries over every vertex of a subdivided mesh: the
+// vector-returning half-edge walks versus spans into the precomputed
+// one-ring tables. Results are compared vertex by vertex.
+//
+// Usage: adjacency_bench [file.obj] [--levels N] [--runs N] [--threads N]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "half_edge.hpp"
+#include "one_ring.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+bool sameElements(const std::vector<HEIndex>& a, IndexSpan b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 3;
+    int runs = 3;
+    unsigned threads = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    ObjMeshData data;
+    if (!bench::loadSubdivided(input, levels, data)) return 1;
+    HalfEdgeMesh mesh;
+    buildHalfEdgeMeshFromPointsAndFaces(data.points, data.faces, mesh);
+    const HEIndex V = static_cast<HEIndex>(mesh.vertexCount());
+    std::printf("%s subdivided %d times: %u vertices, %zu half-edges\n", input.c_str(), levels, V, mesh.halfEdgeCount());
+
+    threads = ThreadPool::resolveThreadCount(threads);
+    ThreadPool pool(threads);
+    VertexOneRing ring;
+    double bestBuild = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = bench::Clock::now();
+        buildVertexOneRing(mesh, ring, &pool);
+        bestBuild = std::min(bestBuild, bench::secondsSince(start));
+    }
+    std::printf("one-ring build (%u threads): %8.3f ms\n", threads, bestBuild * 1000.0);
+
+    // Checksums keep the query loops from being optimized away
+    size_t sumOld = 0, sumNew = 0;
+    double bestOldFaces = 1e30, bestNewFaces = 1e30, bestOldEdges = 1e30, bestNewEdges = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = bench::Clock::now();
+        for (HEIndex v = 0; v < V; ++v) sumOld += getFacesOfVertex(mesh, v).size();
+        bestOldFaces = std::min(bestOldFaces, bench::secondsSince(start));
+
+        start = bench::Clock::now();
+        for (HEIndex v = 0; v < V; ++v) {
+            for (HEIndex f : facesOfVertex(ring, v)) sumNew += f != HE_INVALID;
+        }
+        bestNewFaces = std::min(bestNewFaces, bench::secondsSince(start));
+
+        start = bench::Clock::now();
+        for (HEIndex v = 0; v < V; ++v) sumOld += getEdgesOfVertex(mesh, v).size();
+        bestOldEdges = std::min(bestOldEdges, bench::secondsSince(start));
+
+        start = bench::Clock::now();
+        for (HEIndex v = 0; v < V; ++v) {
+            for (HEIndex h : edgesOfVertex(ring, v)) sumNew += h != HE_INVALID;
+        }
+        bestNewEdges = std::min(bestNewEdges, bench::secondsSince(start));
+    }
+    std::printf("faces of vertex:  walk %8.2f M queries/s   one-ring %8.2f M queries/s  %.1fx\n",
+                V / bestOldFaces * 1e-6, V / bestNewFaces * 1e-6, bestOldFaces / bestNewFaces);
+    std::printf("edges of vertex:  walk %8.2f M queries/s   one-ring %8.2f M queries/s  %.1fx\n",
+                V / bestOldEdges * 1e-6, V / bestNewEdges * 1e-6, bestOldEdges / bestNewEdges);
+
+    size_t mismatches = 0;
+    for (HEIndex v = 0; v < V; ++v) {
+        if (!sameElements(getFacesOfVertex(mesh, v), facesOfVertex(ring, v)) ||
+            !sameElements(getEdgesOfVertex(mesh, v), edgesOfVertex(ring, v))) {
+            if (mismatches++ < 5) std::printf("mismatch at vertex %u\n", v);
+        }
+    }
+    std::printf("results: %s (checksums %zu / %zu)\n", mismatches ? "MISMATCH" : "identical", sumOld, sumNew);
+    return mismatches ? 1 : 0;
+}
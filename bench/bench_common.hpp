@@ -0,0 +1,155 @@
+// Helpers shared by the benchmark executables.
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "mesh.hpp"
+#include "obj_loader.hpp"
+#include "utils.hpp"
+
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Write `copies` translated copies of the mesh as a new OBJ file
+inline bool writeScaledOBJ(const ObjMeshData& src, int copies, const std::string& path) {
+    std::ofstream out(path);
+    if (!out.is_open()) return false;
+    char line[128];
+    for (int c = 0; c < copies; ++c) {
+        float shift = 0.25f * c;
+        for (const Point& p : src.points) {
+            int n = std::snprintf(line, sizeof(line), "v %.7e %.7e %.7e\n", p.x + shift, p.y, p.z);
+            out.write(line, n);
+        }
+        const int base = static_cast<int>(src.points.size()) * c + 1;
+        for (size_t f = 0; f < src.faces.size(); ++f) {
+            out << 'f';
+            const int* face = src.faces.face(f);
+            for (int k = 0; k < src.faces.faceSize(f); ++k) out << ' ' << face[k] + base;
+            out << '\n';
+        }
+    }
+    return true;
+}
+
+inline double fileMegabytes(const std::string& path) {
+    std::ifstream probe(path, std::ios::binary | std::ios::ate);
+    return static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+}
+
+// One level of midpoint subdivision: every triangle becomes four, edge
+// midpoints are shared between neighbours. Non-triangles are copied as is.
+inline ObjMeshData subdivideTriangles(const ObjMeshData& src) {
+    ObjMeshData out;
+    out.points = src.points;
+    std::unordered_map<uint64_t, int> midpoints;
+    midpoints.reserve(src.faces.indices.size());
+    auto midpoint = [&](int a, int b) {
+        uint64_t key = a < b ? (uint64_t(a) << 32) | uint32_t(b) : (uint64_t(b) << 32) | uint32_t(a);
+        auto it = midpoints.find(key);
+        if (it != midpoints.end()) return it->second;
+        const Point& p = out.points[a];
+        const Point& q = out.points[b];
+        out.points.push_back({(p.x + q.x) * 0.5f, (p.y + q.y) * 0.5f, (p.z + q.z) * 0.5f});
+        int idx = static_cast<int>(out.points.size()) - 1;
+        midpoints.emplace(key, idx);
+        return idx;
+    };
+    auto addFace = [&](std::initializer_list<int> inds) {
+        out.faces.indices.insert(out.faces.indices.end(), inds);
+        out.faces.endFace();
+    };
+    for (size_t f = 0; f < src.faces.size(); ++f) {
+        const int* v = src.faces.face(f);
+        if (src.faces.faceSize(f) != 3) {
+            out.faces.indices.insert(out.faces.indices.end(), v, v + src.faces.faceSize(f));
+            out.faces.endFace();
+            continue;
+        }
+        int ab = midpoint(v[0], v[1]), bc = midpoint(v[1], v[2]), ca = midpoint(v[2], v[0]);
+        addFace({v[0], ab, ca});
+        addFace({ab, v[1], bc});
+        addFace({ca, bc, v[2]});
+        addFace({ab, bc, ca});
+    }
+    return out;
+}
+
+// Load an OBJ file and subdivide it `levels` times (each level x4 faces)
+inline bool loadSubdivided(const std::string& path, int levels, ObjMeshData& out) {
+    if (!loadOBJ(path, out)) return false;
+    for (int i = 0; i < levels; ++i) out = subdivideTriangles(out);
+    return true;
+}
+
+// Load an OBJ file, subdivide it and build the Mesh connectivity and edge list (no GL)
+inline bool loadMesh(const std::string& path, int levels, Mesh& mesh) {
+    ObjMeshData data;
+    if (!loadSubdivided(path, levels, data)) return false;
+    mesh.points = std::move(data.points);
+    mesh.face_indices = std::move(data.faces);
+    mesh.buildHalfEdge();
+    return true;
+}
+
+// Everything one viewer frame needs to draw a mesh
+struct Frame {
+    glm::mat4 model, view, projection;
+    int width, height;
+    ViewportRect viewport;
+};
+
+// Matrices built from a TransformState exactly as main.cpp builds them
+inline Frame viewerFrame(const TransformState& state, int width, int height, const ViewportRect& viewport) {
+    Frame frame;
+    frame.width = width;
+    frame.height = height;
+    frame.viewport = viewport;
+    frame.projection = glm::perspective(glm::radians(state.pov), float(width) / float(height), 0.1f, 100.0f);
+    frame.view = glm::translate(glm::mat4(1.0f), glm::vec3(state.pan_offset.x, state.pan_offset.y, -3.0f / state.zoom_level));
+    glm::mat4 model(1.0f);
+    model = glm::rotate(model, state.rotation_angle_z, glm::vec3(0.0f, 0.0f, 1.0f));
+    model = glm::rotate(model, state.rotation_angle_y, glm::vec3(0.0f, 1.0f, 0.0f));
+    model = glm::rotate(model, state.rotation_angle_x, glm::vec3(1.0f, 0.0f, 0.0f));
+    frame.model = model;
+    return frame;
+}
+
+// A turntable around the mesh: `frames` steps of a full turn about y,
+// zoomed and panned so the mesh roughly fills a width x height window
+// with a 100 px clip margin
+inline std::vector<Frame> orbitFrames(const std::vector<Point>& points, int frames, int width, int height) {
+    Point lo = points.empty() ? Point{0, 0, 0} : points[0], hi = lo;
+    for (const Point& p : points) {
+        lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+        hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+    }
+    const float radius = 0.5f * std::max({hi.x - lo.x, hi.y - lo.y, hi.z - lo.z, 1e-6f});
+    TransformState state;
+    state.zoom_level = 3.0f / (2.5f * radius);
+    state.pan_offset = glm::vec2(-0.5f * (lo.x + hi.x), -0.5f * (lo.y + hi.y));
+    const ViewportRect viewport{100, 100, width - 100, height - 100};
+    std::vector<Frame> result;
+    for (int i = 0; i < frames; ++i) {
+        state.rotation_angle_y = 6.2831853f * i / frames;
+        result.push_back(viewerFrame(state, width, height, viewport));
+    }
+    return result;
+}
+
+} // namespace bench
@@ -0,0 +1,121 @@
+// Whole-mesh polygon clipping in faces/s: one weiler_atherton_clip() call
+// per face (a WA_Polygon built per face, four passes each returning a new
+// polygon) versus weiler_atherton_clip_faces() into reused CSR arrays with
+// outcode trivial accept/reject. The viewport rectangle is centred on a
+// 1080x1080 screen at several sizes, from larger than the screen (every
+// face accepted) down to a small window (most faces rejected). The batch
+// output is compared polygon by polygon with the per-face clipper.
+//
+// Usage: clip_bench [file.obj] [--levels N] [--frames N]
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "mesh.hpp"
+#include "weiler-atherton-clip.hpp"
+
+namespace {
+
+// Old per-face loop of Mesh::clipFacesToViewport; returns the number of output vertices
+size_t clipPerFace(const FaceList& faces, const ProjectedVertices& screen, const WA_Viewport& vp,
+                   std::vector<WA_Polygon>* keep) {
+    size_t vertices = 0;
+    for (size_t f = 0; f < faces.size(); ++f) {
+        WA_Polygon poly;
+        const int* face = faces.face(f);
+        bool visible = true;
+        uint8_t frustumAnd = 0xFF;
+        for (int k = 0; k < faces.faceSize(f) && visible; ++k) {
+            visible = screen.visible(face[k]);
+            frustumAnd &= screen.clipCodes[face[k]];
+            poly.emplace_back(screen.screen[face[k]].x, screen.screen[face[k]].y);
+        }
+        // The batch drops faces off screen even when the viewport reaches past it
+        if (!visible || frustumAnd) continue;
+        WA_ClipResult result = weiler_atherton_clip(poly, vp);
+        vertices += result.clipped.size();
+        if (keep && !result.clipped.empty()) keep->push_back(result.clipped);
+    }
+    return vertices;
+}
+
+// Polygons that differ from the per-face result in size or in any coordinate
+size_t countMismatches(const std::vector<WA_Polygon>& reference, const WA_ClippedPolygons& batch) {
+    size_t mismatches = reference.size() > batch.size() ? reference.size() - batch.size() : batch.size() - reference.size();
+    for (size_t p = 0; p < reference.size() && p < batch.size(); ++p) {
+        bool same = reference[p].size() == batch.polygonSize(p);
+        for (size_t k = 0; same && k < reference[p].size(); ++k) {
+            same = reference[p][k].x == batch.polygon(p)[k].x && reference[p][k].y == batch.polygon(p)[k].y;
+        }
+        mismatches += same ? 0 : 1;
+    }
+    return mismatches;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 3;
+    int frameCount = 20;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    Mesh mesh(input);
+    if (!bench::loadMesh(input, levels, mesh)) return 1;
+    const size_t faceCount = mesh.face_indices.size();
+    std::printf("%s subdivided %d times: %zu faces, 1080x1080, %d frames per viewport\n", input.c_str(), levels,
+                faceCount, frameCount);
+
+    const std::vector<bench::Frame> frames = bench::orbitFrames(mesh.points, frameCount, 1080, 1080);
+    std::vector<ProjectedVertices> projected(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const bench::Frame& f = frames[i];
+        projected[i] = mesh.projectToScreenSpace(f.model, f.view, f.projection, f.width, f.height);
+    }
+
+    bool ok = true;
+    WA_ClippedPolygons batch;
+    for (float fraction : {1.2f, 1.0f, 0.75f, 0.5f, 0.25f, 0.1f}) {
+        const float half = 540.0f * fraction;
+        const WA_Viewport vp{540.0f - half, 540.0f - half, 540.0f + half, 540.0f + half};
+
+        size_t sink = 0;
+        auto start = bench::Clock::now();
+        for (const ProjectedVertices& screen : projected) sink += clipPerFace(mesh.face_indices, screen, vp, nullptr);
+        const double perFace = bench::secondsSince(start);
+
+        size_t accepted = 0, rejected = 0, kept = 0;
+        start = bench::Clock::now();
+        for (const ProjectedVertices& screen : projected) {
+            weiler_atherton_clip_faces(mesh.face_indices, screen, vp, batch);
+            accepted += batch.trivialAccepts;
+            rejected += batch.trivialRejects;
+            kept += batch.size();
+        }
+        const double batched = bench::secondsSince(start);
+
+        size_t mismatches = 0;
+        for (const ProjectedVertices& screen : projected) {
+            std::vector<WA_Polygon> reference;
+            clipPerFace(mesh.face_indices, screen, vp, &reference);
+            weiler_atherton_clip_faces(mesh.face_indices, screen, vp, batch);
+            mismatches += countMismatches(reference, batch);
+        }
+        ok = ok && mismatches == 0 && sink > 0;
+
+        const double faces = static_cast<double>(faceCount) * frames.size();
+        std::printf("viewport %4.0f px: per face %7.1f M faces/s | batch %7.1f M faces/s %5.1fx | "
+                    "accept %5.1f%%, reject %5.1f%%, clipped %5.1f%% | %s\n",
+                    2.0f * half, faces / perFace * 1e-6, faces / batched * 1e-6, perFace / batched,
+                    100.0 * accepted / faces, 100.0 * rejected / faces, 100.0 * (kept - accepted) / faces,
+                    mismatches ? "MISMATCH" : "identical");
+    }
+    return ok ? 0 : 1;
+}
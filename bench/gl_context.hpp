@@ -0,0 +1,25 @@
+// Hidden-window GL context for the benchmarks that draw.
+#pragma once
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+namespace bench {
+
+// A current GL 3.3 core context on an invisible width x height window with
+// vsync off, or nullptr. Without a GPU, run the benchmark on Mesa's
+// software renderer: LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./<bench>
+inline GLFWwindow* createHiddenContext(int width, int height, const char* title) {
+    if (!glfwInit()) return nullptr;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+    if (!window) return nullptr;
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0);
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) return nullptr;
+    return window;
+}
+
+} // namespace bench
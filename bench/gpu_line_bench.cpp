@@ -0,0 +1,163 @@
+// Antialiased wireframes drawn two ways over a turntable, per subdivision
+// level: the CPU Wu path (project, clip and rasterize every edge, stream
+// one point per pixel, Mesh::drawRasterizedLines) and GPU_WU (static
+// positions and edges, MVP uniform, one instanced quad per edge,
+// Mesh::drawGpuLines). Reported: CPU ms per frame to submit the frame,
+// ms per frame including glFinish(), and bytes uploaded per frame. The
+// GPU_WU submit time should stay flat as the mesh grows.
+//
+// Correctness: on the first frame both images are read back; at least 99%
+// of the pixels the CPU path covers by half or more must be lit by GPU_WU
+// within one pixel, and GPU_WU's total intensity must be within the range
+// its box filter allows against Wu (which spreads one pixel of intensity
+// per step along the major axis, so diagonal lines carry less).
+//
+// Needs a GL 3.3 context; without a GPU:
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./gpu_line_bench
+//
+// Usage: gpu_line_bench [file.obj] [--levels N] [--frames N]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "gl_context.hpp"
+#include "gpu_buffer_pool.hpp"
+#include "mesh.hpp"
+#include "shader.hpp"
+
+namespace {
+
+const int kSize = 1080;
+
+struct Timing {
+    double submitMs = 0.0, finishedMs = 0.0;
+};
+
+std::vector<unsigned char> readRed() {
+    std::vector<unsigned char> rgba(static_cast<size_t>(kSize) * kSize * 4), red(static_cast<size_t>(kSize) * kSize);
+    glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+    for (size_t i = 0; i < red.size(); ++i) red[i] = rgba[i * 4];
+    return red;
+}
+
+// Share of the pixels cpu covers by half or more that gpu lights within one pixel
+double coveredShare(const std::vector<unsigned char>& cpu, const std::vector<unsigned char>& gpu) {
+    size_t strong = 0, matched = 0;
+    for (int y = 1; y < kSize - 1; ++y) {
+        for (int x = 1; x < kSize - 1; ++x) {
+            if (cpu[y * kSize + x] < 128) continue;
+            ++strong;
+            bool lit = false;
+            for (int dy = -1; dy <= 1 && !lit; ++dy) {
+                for (int dx = -1; dx <= 1 && !lit; ++dx) lit = gpu[(y + dy) * kSize + x + dx] > 0;
+            }
+            matched += lit;
+        }
+    }
+    return strong ? static_cast<double>(matched) / strong : 1.0;
+}
+
+double totalIntensity(const std::vector<unsigned char>& image) {
+    double sum = 0.0;
+    for (unsigned char v : image) sum += v / 255.0;
+    return sum;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int maxLevels = 3;
+    int frameCount = 30;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) maxLevels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    GLFWwindow* window = bench::createHiddenContext(kSize, kSize, "gpu_line_bench");
+    if (!window) {
+        std::fprintf(stderr, "Could not create a GL 3.3 context (try LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a)\n");
+        return 1;
+    }
+    std::printf("GL %s, %s\n", reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+                reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+
+    Shader wuShader("shaders/wu_line.vert", "shaders/wu_line.frag");
+    Shader gpuShader("shaders/wu_line_gpu.vert", "shaders/wu_line_gpu.frag");
+    const glm::vec4 white(1.0f);
+    bool ok = true;
+    for (int levels = 0; levels <= maxLevels; ++levels) {
+        Mesh mesh(input);
+        if (!bench::loadMesh(input, levels, mesh)) return 1;
+        GpuBufferPool pool;
+        if (!pool.init()) return 1;
+        mesh.setupMesh(pool);
+        if (!mesh.gpuLinesSupported) {
+            std::printf("level %d: %zu vertices exceed the texture buffer limit, skipped\n", levels, mesh.points.size());
+            pool.destroy();
+            continue;
+        }
+        // Clip to the whole window, so both paths cover the same pixels
+        std::vector<bench::Frame> frames = bench::orbitFrames(mesh.points, frameCount, kSize, kSize);
+        for (bench::Frame& f : frames) f.viewport = ViewportRect{0, 0, kSize, kSize};
+
+        auto drawCpu = [&](const bench::Frame& f) {
+            mesh.setRenderMode(Mesh::XIAOLIN_WU);
+            mesh.drawRasterizedLines(&wuShader, f.model, f.view, f.projection, f.width, f.height, white, f.viewport);
+            pool.endFrame();
+        };
+        auto drawGpu = [&](const bench::Frame& f) {
+            mesh.setRenderMode(Mesh::GPU_WU);
+            mesh.drawGpuLines(&gpuShader, f.model, f.view, f.projection, f.width, f.height, white, f.viewport);
+        };
+        // Warm up once, then time every frame on its own
+        auto run = [&](const std::function<void(const bench::Frame&)>& draw) {
+            Timing t;
+            for (int round = 0; round < 2; ++round) {
+                for (const bench::Frame& f : frames) {
+                    glClear(GL_COLOR_BUFFER_BIT);
+                    auto start = bench::Clock::now();
+                    draw(f);
+                    const double submit = bench::secondsSince(start);
+                    glFinish();
+                    if (round == 0) continue;
+                    t.submitMs += submit * 1000.0 / frames.size();
+                    t.finishedMs += bench::secondsSince(start) * 1000.0 / frames.size();
+                }
+            }
+            return t;
+        };
+
+        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        drawCpu(frames[0]);
+        const std::vector<unsigned char> cpuImage = readRed();
+        const double uploadMB = pool.framePoints() * sizeof(WuVertex) / 1e6;
+        glClear(GL_COLOR_BUFFER_BIT);
+        drawGpu(frames[0]);
+        const std::vector<unsigned char> gpuImage = readRed();
+
+        const Timing cpu = run(drawCpu);
+        const Timing gpu = run(drawGpu);
+
+        const double share = coveredShare(cpuImage, gpuImage);
+        const double intensity = totalIntensity(gpuImage) / std::max(1.0, totalIntensity(cpuImage));
+        const bool pass = share >= 0.99 && intensity > 0.8 && intensity < 1.5;
+        ok = ok && pass;
+        std::printf("level %d, %8zu edges | CPU Wu %8.2f ms submit %8.2f ms finished %7.2f MB/frame | "
+                    "GPU_WU %6.3f ms submit %8.2f ms finished %4.2f MB/frame | covered %.4f, intensity x%.2f  %s\n",
+                    levels, mesh.edge_indices.size(), cpu.submitMs, cpu.finishedMs, uploadMB, gpu.submitMs,
+                    gpu.finishedMs, 0.0, share, intensity, pass ? "ok" : "MISMATCH");
+        pool.destroy();
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+// Half-edge construction time on a subdivided mesh, serial versus the
+// parallel build with 1, 2, 4, ... threads. Every parallel result is
+// compared array by array with the serial one.
+//
+// Usage: halfedge_bench [file.obj] [--levels N] [--runs N] [--threads N]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "bench_common.hpp"
+#include "half_edge.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+bool sameConnectivity(const HalfEdgeMesh& a, const HalfEdgeMesh& b) {
+    return a.origin == b.origin && a.twin == b.twin && a.next == b.next && a.face == b.face &&
+           a.vertexEdge == b.vertexEdge && a.faceEdge == b.faceEdge;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 4;
+    int runs = 3;
+    unsigned maxThreads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) maxThreads = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    ObjMeshData data;
+    if (!bench::loadSubdivided(input, levels, data)) return 1;
+    std::printf("%s subdivided %d times: %zu vertices, %zu faces, %zu half-edges\n",
+                input.c_str(), levels, data.points.size(), data.faces.size(), data.faces.indices.size());
+
+    HalfEdgeMesh serial;
+    double bestSerial = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto start = bench::Clock::now();
+        buildHalfEdgeMeshFromPointsAndFaces(data.points, data.faces, serial);
+        bestSerial = std::min(bestSerial, bench::secondsSince(start));
+    }
+    std::printf("serial:      %8.3f s  %8.2f M half-edges/s\n", bestSerial, data.faces.indices.size() / bestSerial * 1e-6);
+
+    maxThreads = ThreadPool::resolveThreadCount(maxThreads);
+    bool identical = true;
+    for (unsigned threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+        ThreadPool pool(threads);
+        HalfEdgeMesh parallel;
+        double best = 1e30;
+        for (int r = 0; r < runs; ++r) {
+            auto start = bench::Clock::now();
+            buildHalfEdgeMeshFromPointsAndFaces(data.points, data.faces, parallel, &pool);
+            best = std::min(best, bench::secondsSince(start));
+        }
+        bool same = sameConnectivity(serial, parallel);
+        identical = identical && same;
+        std::printf("%2u threads:  %8.3f s  %8.2f M half-edges/s  %.2fx  %s\n", threads, best,
+                    data.faces.indices.size() / best * 1e-6, bestSerial / best, same ? "identical" : "MISMATCH");
+        if (threads == maxThreads) break;
+    }
+    return identical ? 0 : 1;
+}
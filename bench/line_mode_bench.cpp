@@ -0,0 +1,195 @@
+// All render modes on the same turntable scene at several subdivision
+// levels. The CPU modes (Wu, Bresenham, DDA) are timed end to end through
+// Mesh::buildLineVertices() and report the points and bytes they upload
+// every frame. The hardware modes (GL_LINES, GL_POINTS) upload positions and
+// edge indices once, which is reported instead.
+//
+// GPU time is only measured with --gl, on a hidden GL 3.3 context: every mode
+// is then drawn as the viewer draws it (drawRasterizedLines or drawWithGL),
+// reporting the CPU ms to submit a frame and the ms until glFinish() returns.
+// Without --gl the hardware modes' times print as n/a.
+//
+// Each CPU rasterizer is also checked on random segments: it never writes
+// more than pixelBound(), and the aliased ones produce an 8-connected run
+// of pixels from the rounded start point to within a pixel of the rounded
+// end point.
+//
+// Without a GPU: LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a ./line_mode_bench --gl
+//
+// Usage: line_mode_bench [file.obj] [--levels N] [--frames N] [--gl]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "gl_context.hpp"
+#include "gpu_buffer_pool.hpp"
+#include "line_rasterizer.hpp"
+#include "mesh.hpp"
+#include "shader.hpp"
+
+namespace {
+
+const int kSize = 1080;
+
+struct Timing {
+    double submitMs = 0.0, finishedMs = 0.0;
+};
+
+// Mean per frame of draw(f) and of draw(f) plus glFinish(), after one untimed frame
+Timing timeDrawn(const std::vector<bench::Frame>& frames, const std::function<void(const bench::Frame&)>& draw) {
+    Timing t;
+    glClear(GL_COLOR_BUFFER_BIT);
+    draw(frames[0]);
+    glFinish();
+    for (const bench::Frame& f : frames) {
+        glClear(GL_COLOR_BUFFER_BIT);
+        const auto start = bench::Clock::now();
+        draw(f);
+        t.submitMs += bench::secondsSince(start) * 1000.0 / frames.size();
+        glFinish();
+        t.finishedMs += bench::secondsSince(start) * 1000.0 / frames.size();
+    }
+    return t;
+}
+
+glm::vec2 pixelOf(glm::vec2 p) { return glm::vec2(std::round(p.x), std::round(p.y)); }
+
+bool checkRasterizer(const LineRasterizer& rasterizer, bool aliased) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(0.0f, 300.0f);
+    std::vector<WuVertex> out;
+    for (int i = 0; i < 20000; ++i) {
+        // Every tenth segment is degenerate or tiny
+        const glm::vec2 p0(coord(rng), coord(rng));
+        const glm::vec2 p1 = i % 10 == 0 ? p0 + glm::vec2(coord(rng), coord(rng)) * 0.002f : glm::vec2(coord(rng), coord(rng));
+        const size_t bound = rasterizer.pixelBound(p0, p1);
+        out.resize(bound + 1);
+        const size_t written = static_cast<size_t>(rasterizer.rasterize(p0, p1, glm::vec3(1.0f), out.data()) - out.data());
+        if (written > bound || written == 0) return false;
+        if (!aliased) continue;
+        // DDA rounds the accumulated end point, which can land a pixel off
+        const glm::vec2 last = out[written - 1].position - pixelOf(p1);
+        if (out[0].position != pixelOf(p0) || std::abs(last.x) > 1.0f || std::abs(last.y) > 1.0f) return false;
+        for (size_t k = 1; k < written; ++k) {
+            const glm::vec2 step = out[k].position - out[k - 1].position;
+            if (std::abs(step.x) > 1.0f || std::abs(step.y) > 1.0f) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int maxLevel = 2;
+    int frameCount = 30;
+    bool useGL = false;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) maxLevel = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--gl")) useGL = true;
+        else input = argv[i];
+    }
+
+    GLFWwindow* window = nullptr;
+    if (useGL) {
+        window = bench::createHiddenContext(kSize, kSize, "line_mode_bench");
+        if (!window) {
+            std::fprintf(stderr, "Could not create a GL 3.3 context (try LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a)\n");
+            return 1;
+        }
+        std::printf("GL %s, %s\n", reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+                    reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    }
+    // The viewer's shaders for the CPU modes' points and the hardware modes
+    std::unique_ptr<Shader> pointShader, lineShader;
+    if (useGL) {
+        pointShader.reset(new Shader("shaders/wu_line.vert", "shaders/wu_line.frag"));
+        lineShader.reset(new Shader("shaders/vertex_core.glsl", "shaders/fragment_core.glsl"));
+    }
+
+    struct Mode {
+        const char* label;
+        Mesh::RenderMode mode;
+    };
+    const Mode cpuModes[] = {{"Wu", Mesh::XIAOLIN_WU}, {"Bresenham", Mesh::BRESENHAM}, {"DDA", Mesh::DDA}};
+
+    bool ok = true;
+    for (const Mode& m : cpuModes) {
+        Mesh probe(input);
+        probe.setRenderMode(m.mode);
+        const bool pass = checkRasterizer(*probe.lineRasterizer(), m.mode != Mesh::XIAOLIN_WU);
+        ok = ok && pass;
+        std::printf("%-10s random segments: %s\n", m.label, pass ? "ok" : "FAILED");
+    }
+
+    const glm::vec4 color(1.0f, 0.5f, 0.5f, 1.0f);
+    for (int level = 0; level <= maxLevel; ++level) {
+        Mesh mesh(input);
+        if (!bench::loadMesh(input, level, mesh)) return 1;
+        const std::vector<bench::Frame> frames = bench::orbitFrames(mesh.points, frameCount, kSize, kSize);
+        std::printf("level %d: %zu vertices, %zu unique edges, %dx%d, %d frames\n", level, mesh.points.size(),
+                    mesh.edge_indices.size(), kSize, kSize, frameCount);
+        GpuBufferPool pool;
+        if (useGL) {
+            if (!pool.init()) return 1;
+            mesh.setupMesh(pool);
+        }
+        // " | submit X ms  drawn Y ms/frame" with --gl, nothing otherwise
+        auto drawnColumns = [&](const std::function<void(const bench::Frame&)>& draw) {
+            if (!useGL) return std::string();
+            const Timing t = timeDrawn(frames, draw);
+            char text[64];
+            std::snprintf(text, sizeof(text), " | submit %7.2f ms  drawn %8.2f ms/frame", t.submitMs, t.finishedMs);
+            return std::string(text);
+        };
+
+        for (const Mode& m : cpuModes) {
+            mesh.setRenderMode(m.mode);
+            size_t points = 0;
+            auto start = bench::Clock::now();
+            for (const bench::Frame& f : frames) {
+                mesh.buildLineVertices(f.model, f.view, f.projection, f.width, f.height, color, f.viewport);
+                points += mesh.wu_vertex_buffer.size();
+            }
+            const double ms = bench::secondsSince(start) * 1000.0 / frames.size();
+            const std::string drawn = drawnColumns([&](const bench::Frame& f) {
+                mesh.drawRasterizedLines(pointShader.get(), f.model, f.view, f.projection, f.width, f.height, color, f.viewport);
+                pool.endFrame();
+            });
+            std::printf("  %-10s %8.2f ms/frame  %10zu points  %7.2f MB/frame upload%s\n", m.label, ms,
+                        points / frames.size(), points / frames.size() * sizeof(WuVertex) / 1e6, drawn.c_str());
+        }
+        // No CPU stage to time on their own: only --gl measures them
+        const double staticMB = (mesh.points.size() * sizeof(Point) + mesh.edge_indices.size() * 2 * sizeof(unsigned)) / 1e6;
+        const Mode hardwareModes[] = {{"GL_LINES", Mesh::LINES}, {"GL_POINTS", Mesh::POINTS}};
+        for (const Mode& m : hardwareModes) {
+            mesh.setRenderMode(m.mode);
+            const std::string drawn = drawnColumns([&](const bench::Frame& f) {
+                mesh.drawWithGL(lineShader.get(), f.model, f.view, f.projection, f.height, color, f.viewport);
+            });
+            const bool lines = m.mode == Mesh::LINES;
+            std::printf("  %-10s %8s ms/frame  %10zu %s  %7.2f MB once%s\n", m.label, "n/a",
+                        lines ? mesh.edge_indices.size() : mesh.points.size(), lines ? "lines " : "points", staticMB, drawn.c_str());
+        }
+        mesh.destroy();
+        pool.destroy();
+    }
+
+    if (window) {
+        pointShader.reset();
+        lineShader.reset();
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+    return ok ? 0 : 1;
+}
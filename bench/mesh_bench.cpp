@@ -0,0 +1,456 @@
+// Replays a scripted camera sequence over one or more meshes and reports
+// p50/p95/p99 per stage as JSON, so runs can be compared across commits.
+//
+// The script is a list of keyframes holding TransformState values plus the
+// viewer's shear and viewport rectangle; each keyframe is reached from the
+// previous one in "frames" linearly interpolated steps and omitted values
+// carry over. Without --script a built-in sequence fitted to the meshes is
+// used (every frame keeps the meshes in view, at any scale): a full turn, a
+// close-up with tilt, a pan and roll, shear on and off, the viewport
+// shrinking to the centre and back while zooming out (286 frames). --dump-script writes the sequence in use, as a starting
+// point for custom scripts:
+//
+//   {"size": [1080, 1080],
+//    "keyframes": [{"frames": 0, "zoom_level": 5.93, "rotation_angle_x": 0, "rotation_angle_y": 0,
+//                   "rotation_angle_z": 0, "pov": 45, "pan_offset_x": 0, "pan_offset_y": 0,
+//                   "shear": 0, "viewport": [100, 100, 980, 980]},
+//                  {"frames": 90, "rotation_angle_y": 6.283}, ...]}
+//
+// Stages per frame, summed over the meshes: projection
+// (projectToScreenSpace), clipping (clipToViewport or clipFacesToViewport),
+// rasterization (rasterizeSegments with the --mode rasterizer), and with
+// --gl upload (GpuBufferPool::streamPoints) and draw (GL_POINTS draw up to
+// glFinish) on a hidden GL 3.3 context; without --gl those two are null.
+// Near and far planes are fitted around the meshes on every frame, so large
+// meshes are not far-clipped as by the viewer's fixed 0.1-100 range.
+// One untimed warm-up pass precedes --repeat timed passes. Correctness: every
+// timed pass must rasterize exactly as many points per frame as the warm-up
+// pass ("deterministic" in the JSON), and at least one frame must keep some
+// segment after clipping ("empty_frames" counts those that keep none);
+// otherwise the exit status is 1.
+//
+// Usage: mesh_bench [file.obj ...] [--levels N] [--script file.json] [--dump-script file.json]
+//                   [--repeat N] [--threads N] [--mode wu|bresenham|dda] [--faces] [--gl] [--json file.json|-]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "bench_common.hpp"
+#include "gl_context.hpp"
+#include "gpu_buffer_pool.hpp"
+#include "mesh.hpp"
+#include "shader.hpp"
+#include "thread_pool.hpp"
+
+using json = nlohmann::json;
+
+namespace {
+
+// Everything a keyframe can set
+struct CameraKey {
+    int frames = 0;
+    TransformState state;
+    float shear = 0.0f;
+    ViewportRect viewport{100, 100, 980, 980};
+};
+
+json keyToJson(const CameraKey& key) {
+    return json{{"frames", key.frames},
+                {"zoom_level", key.state.zoom_level},
+                {"rotation_angle_x", key.state.rotation_angle_x},
+                {"rotation_angle_y", key.state.rotation_angle_y},
+                {"rotation_angle_z", key.state.rotation_angle_z},
+                {"pov", key.state.pov},
+                {"pan_offset_x", key.state.pan_offset.x},
+                {"pan_offset_y", key.state.pan_offset.y},
+                {"shear", key.shear},
+                {"viewport", {key.viewport.x_min, key.viewport.y_min, key.viewport.x_max, key.viewport.y_max}}};
+}
+
+// Fields missing from j keep the values of previous
+CameraKey keyFromJson(const json& j, const CameraKey& previous) {
+    CameraKey key = previous;
+    key.frames = j.value("frames", 0);
+    key.state.zoom_level = j.value("zoom_level", key.state.zoom_level);
+    key.state.rotation_angle_x = j.value("rotation_angle_x", key.state.rotation_angle_x);
+    key.state.rotation_angle_y = j.value("rotation_angle_y", key.state.rotation_angle_y);
+    key.state.rotation_angle_z = j.value("rotation_angle_z", key.state.rotation_angle_z);
+    key.state.pov = j.value("pov", key.state.pov);
+    key.state.pan_offset.x = j.value("pan_offset_x", key.state.pan_offset.x);
+    key.state.pan_offset.y = j.value("pan_offset_y", key.state.pan_offset.y);
+    key.shear = j.value("shear", key.shear);
+    if (j.contains("viewport")) {
+        const json& v = j.at("viewport");
+        key.viewport = ViewportRect{v.at(0).get<int>(), v.at(1).get<int>(), v.at(2).get<int>(), v.at(3).get<int>()};
+    }
+    return key;
+}
+
+struct Script {
+    int width = 1080, height = 1080;
+    std::vector<CameraKey> keys;
+};
+
+bool loadScript(const std::string& path, Script& script) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Failed to open script " << path << std::endl;
+        return false;
+    }
+    try {
+        json j;
+        in >> j;
+        if (j.contains("size")) {
+            script.width = j.at("size").at(0).get<int>();
+            script.height = j.at("size").at(1).get<int>();
+        }
+        CameraKey previous;
+        previous.viewport = ViewportRect{100, 100, script.width - 100, script.height - 100};
+        for (const json& k : j.at("keyframes")) {
+            previous = keyFromJson(k, previous);
+            script.keys.push_back(previous);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid script " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    if (script.keys.empty()) {
+        std::cerr << "Script " << path << " has no keyframes" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Largest distance of any vertex from the origin, which the model matrix rotates about
+float originReach(const std::vector<Point>& points) {
+    float reach = 0.0f;
+    for (const Point& p : points) reach = std::max(reach, std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z));
+    return std::max(reach, 1e-6f);
+}
+
+// The built-in sequence. The viewer rotates about the origin, so the framing fits the
+// sphere around the origin that holds every vertex (not the bounding box, which a pan
+// would only keep centred until the first rotation); that keeps the meshes in view at
+// any rotation and any mesh scale
+Script builtinScript(const std::vector<Point>& points, int width, int height) {
+    Script script;
+    script.width = width;
+    script.height = height;
+    const float reach = originReach(points);
+    CameraKey key;
+    key.state.zoom_level = 3.0f / (2.5f * reach);
+    key.viewport = ViewportRect{100, 100, width - 100, height - 100};
+    const CameraKey start = key;
+    script.keys.push_back(key);
+
+    auto add = [&](int frames) {
+        key.frames = frames;
+        script.keys.push_back(key);
+    };
+    key.state.rotation_angle_y = 6.2831853f; // Full turn
+    add(90);
+    key.state.zoom_level *= 1.6f;            // Close-up with tilt
+    key.state.rotation_angle_x = 0.6f;
+    add(45);
+    key.state.pan_offset = glm::vec2(0.3f * reach, -0.2f * reach); // Pan and roll, staying in view
+    key.state.rotation_angle_z = 0.3f;
+    add(45);
+    key.shear = 0.4f;
+    add(30);
+    key.shear = 0.0f;                        // Shear off, viewport shrinks to the centre
+    key.viewport = ViewportRect{int(width * 0.3f), int(height * 0.3f), int(width * 0.7f), int(height * 0.7f)};
+    add(30);
+    key.state = start.state;                 // Back out to the start while turning once more
+    key.state.rotation_angle_y = 2.0f * 6.2831853f;
+    key.viewport = start.viewport;
+    add(45);
+    return script;
+}
+
+json scriptToJson(const Script& script) {
+    json keys = json::array();
+    for (const CameraKey& key : script.keys) keys.push_back(keyToJson(key));
+    return json{{"size", {script.width, script.height}}, {"keyframes", keys}};
+}
+
+// The viewer's camera, except that near and far enclose the scene: the viewer's fixed
+// 0.1-100 range would far-clip large meshes and turn the run into empty frames
+bench::Frame frameAt(const CameraKey& a, const CameraKey& b, float t, int width, int height, float reach) {
+    auto mix = [t](float x, float y) { return x + (y - x) * t; };
+    auto mixi = [t](int x, int y) { return static_cast<int>(std::lround(x + (y - x) * t)); };
+    TransformState s;
+    s.zoom_level = mix(a.state.zoom_level, b.state.zoom_level);
+    s.rotation_angle_x = mix(a.state.rotation_angle_x, b.state.rotation_angle_x);
+    s.rotation_angle_y = mix(a.state.rotation_angle_y, b.state.rotation_angle_y);
+    s.rotation_angle_z = mix(a.state.rotation_angle_z, b.state.rotation_angle_z);
+    s.pov = mix(a.state.pov, b.state.pov);
+    s.pan_offset = glm::vec2(mix(a.state.pan_offset.x, b.state.pan_offset.x), mix(a.state.pan_offset.y, b.state.pan_offset.y));
+    const ViewportRect viewport{mixi(a.viewport.x_min, b.viewport.x_min), mixi(a.viewport.y_min, b.viewport.y_min),
+                                mixi(a.viewport.x_max, b.viewport.x_max), mixi(a.viewport.y_max, b.viewport.y_max)};
+    bench::Frame frame = bench::viewerFrame(s, width, height, viewport);
+    // Shear is applied before the rotations, as in main.cpp's viewport mode
+    glm::mat4 shear(1.0f);
+    shear[1][0] = mix(a.shear, b.shear);
+    frame.model = shear * frame.model;
+    // Sheared and rotated, the mesh stays within reach * (1 + |shear|) of the point the
+    // view moves 3 / zoom in front of the camera
+    const float extent = 1.05f * reach * (1.0f + std::abs(shear[1][0]));
+    const float distance = 3.0f / s.zoom_level;
+    const float zFar = distance + extent;
+    const float zNear = std::max(distance - extent, 1e-4f * zFar);
+    frame.projection = glm::perspective(glm::radians(s.pov), float(width) / float(height), zNear, zFar);
+    return frame;
+}
+
+// Every step of the script: the first keyframe, then each keyframe's interpolated steps
+std::vector<bench::Frame> expandScript(const Script& script, float reach) {
+    std::vector<bench::Frame> frames;
+    frames.push_back(frameAt(script.keys[0], script.keys[0], 0.0f, script.width, script.height, reach));
+    for (size_t k = 1; k < script.keys.size(); ++k) {
+        const int steps = std::max(script.keys[k].frames, 1);
+        for (int i = 1; i <= steps; ++i) {
+            frames.push_back(frameAt(script.keys[k - 1], script.keys[k], float(i) / steps, script.width, script.height, reach));
+        }
+    }
+    return frames;
+}
+
+// Nearest-rank percentiles and the mean of one stage's per-frame times
+json stageStats(std::vector<double> ms) {
+    if (ms.empty()) return nullptr;
+    std::sort(ms.begin(), ms.end());
+    auto percentile = [&](double p) {
+        const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * ms.size()));
+        return ms[std::min(ms.size() - 1, rank > 0 ? rank - 1 : 0)];
+    };
+    double sum = 0.0;
+    for (double v : ms) sum += v;
+    return json{{"p50_ms", percentile(50)}, {"p95_ms", percentile(95)}, {"p99_ms", percentile(99)},
+                {"mean_ms", sum / ms.size()}, {"min_ms", ms.front()}, {"max_ms", ms.back()}};
+}
+
+double msSince(bench::Clock::time_point start) {
+    return bench::secondsSince(start) * 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    std::string scriptPath, dumpPath, jsonPath;
+    int levels = 2, repeat = 3;
+    unsigned threads = 1;
+    bool useGL = false;
+    Mesh::RenderMode mode = Mesh::XIAOLIN_WU;
+    Mesh::WuEdgeSource edgeSource = Mesh::UNIQUE_EDGES;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--script") && i + 1 < argc) scriptPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--dump-script") && i + 1 < argc) dumpPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--json") && i + 1 < argc) jsonPath = argv[++i];
+        else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (!std::strcmp(argv[i], "--faces")) edgeSource = Mesh::FACE_POLYGONS;
+        else if (!std::strcmp(argv[i], "--gl")) useGL = true;
+        else if (!std::strcmp(argv[i], "--mode") && i + 1 < argc) {
+            const std::string m = argv[++i];
+            if (m == "wu") mode = Mesh::XIAOLIN_WU;
+            else if (m == "bresenham") mode = Mesh::BRESENHAM;
+            else if (m == "dda") mode = Mesh::DDA;
+            else {
+                std::fprintf(stderr, "Unknown mode: %s (wu, bresenham or dda)\n", m.c_str());
+                return 1;
+            }
+        } else inputs.push_back(argv[i]);
+    }
+    if (inputs.empty()) inputs.push_back("assets/bunny.obj");
+
+    std::vector<std::unique_ptr<Mesh>> meshes;
+    std::vector<Point> allPoints;
+    json meshInfo = json::array();
+    for (const std::string& input : inputs) {
+        meshes.emplace_back(new Mesh(input));
+        Mesh& mesh = *meshes.back();
+        if (!bench::loadMesh(input, levels, mesh)) return 1;
+        mesh.setRenderMode(mode);
+        mesh.wuEdgeSource = edgeSource;
+        allPoints.insert(allPoints.end(), mesh.points.begin(), mesh.points.end());
+        meshInfo.push_back({{"file", input}, {"vertices", mesh.points.size()}, {"faces", mesh.face_indices.size()},
+                            {"edges", mesh.edge_indices.size()}});
+    }
+
+    Script script;
+    if (!scriptPath.empty()) {
+        if (!loadScript(scriptPath, script)) return 1;
+    } else {
+        script = builtinScript(allPoints, 1080, 1080);
+    }
+    if (!dumpPath.empty()) {
+        std::ofstream out(dumpPath);
+        out << scriptToJson(script).dump(2) << "\n";
+    }
+    const std::vector<bench::Frame> frames = expandScript(script, originReach(allPoints));
+
+    const unsigned threadCount = ThreadPool::resolveThreadCount(threads);
+    std::unique_ptr<ThreadPool> pool(threadCount > 1 ? new ThreadPool(threadCount) : nullptr);
+    for (auto& mesh : meshes) mesh->rasterPool = pool.get();
+
+    // Optional GL stages
+    GLFWwindow* window = nullptr;
+    std::unique_ptr<Shader> shader;
+    GpuBufferPool gpuPool;
+    json glInfo = {{"enabled", false}};
+    if (useGL) {
+        window = bench::createHiddenContext(script.width, script.height, "mesh_bench");
+        if (!window) {
+            std::fprintf(stderr, "Could not create a GL 3.3 context (try LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a)\n");
+            return 1;
+        }
+        shader.reset(new Shader("shaders/wu_line.vert", "shaders/wu_line.frag"));
+        if (!gpuPool.init()) return 1;
+        glInfo = {{"enabled", true},
+                  {"version", reinterpret_cast<const char*>(glGetString(GL_VERSION))},
+                  {"renderer", reinterpret_cast<const char*>(glGetString(GL_RENDERER))},
+                  {"stream_mode", gpuPool.stream().modeName()}};
+    }
+
+    const glm::vec4 color(1.0f, 0.5f, 0.5f, 1.0f);
+    std::vector<double> projectMs, clipMs, rasterMs, uploadMs, drawMs, totalMs;
+    double segmentSum = 0.0, pointSum = 0.0;
+    size_t emptyFrames = 0; // Timed frames where clipping left no segment
+    // Points per frame of the warm-up pass; every timed pass must reproduce them
+    std::vector<size_t> expectedPoints;
+    bool deterministic = true;
+    for (int pass = 0; pass <= repeat; ++pass) {
+        const bool timed = pass > 0; // Pass 0 warms caches and grows the buffers
+        for (size_t frameIndex = 0; frameIndex < frames.size(); ++frameIndex) {
+            const bench::Frame& f = frames[frameIndex];
+            double project = 0.0, clip = 0.0, raster = 0.0, upload = 0.0, draw = 0.0;
+            size_t segments = 0, points = 0;
+            if (useGL) glClear(GL_COLOR_BUFFER_BIT);
+            for (auto& meshPtr : meshes) {
+                Mesh& mesh = *meshPtr;
+                auto start = bench::Clock::now();
+                const ProjectedVertices& screen = mesh.projectToScreenSpace(f.model, f.view, f.projection, f.width, f.height);
+                project += msSince(start);
+
+                start = bench::Clock::now();
+                const Mesh::ClipResult clipped = edgeSource == Mesh::UNIQUE_EDGES ? mesh.clipToViewport(screen, f.viewport)
+                                                                                  : mesh.clipFacesToViewport(screen, f.viewport);
+                clip += msSince(start);
+
+                start = bench::Clock::now();
+                mesh.wu_vertex_buffer.clear();
+                mesh.rasterizeSegments(clipped, color, *mesh.lineRasterizer());
+                raster += msSince(start);
+                segments += clipped.visibleEdges.size() + clipped.boundarySegments.size();
+                points += mesh.wu_vertex_buffer.size();
+
+                if (!useGL || mesh.wu_vertex_buffer.empty()) continue;
+                start = bench::Clock::now();
+                mesh.wuRange = gpuPool.streamPoints(mesh.wu_vertex_buffer.data(), mesh.wu_vertex_buffer.size());
+                upload += msSince(start);
+
+                start = bench::Clock::now();
+                shader->activate();
+                shader->setVec2("u_screenSize", glm::vec2(f.width, f.height));
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+                glDisable(GL_DEPTH_TEST);
+                gpuPool.drawPoints(mesh.wuRange);
+                draw += msSince(start);
+            }
+            if (useGL) {
+                const auto start = bench::Clock::now();
+                gpuPool.endFrame();
+                glFinish();
+                draw += msSince(start);
+            }
+            if (!timed) {
+                expectedPoints.push_back(points);
+                continue;
+            }
+            deterministic = deterministic && points == expectedPoints[frameIndex];
+            projectMs.push_back(project);
+            clipMs.push_back(clip);
+            rasterMs.push_back(raster);
+            if (useGL) {
+                uploadMs.push_back(upload);
+                drawMs.push_back(draw);
+            }
+            totalMs.push_back(project + clip + raster + upload + draw);
+            segmentSum += segments;
+            pointSum += points;
+            emptyFrames += segments == 0;
+        }
+    }
+
+    const size_t timedFrames = totalMs.size();
+    const char* modeName = meshes[0]->lineRasterizer()->name();
+    json result = {{"benchmark", "mesh_bench"},
+                   {"meshes", meshInfo},
+                   {"levels", levels},
+                   {"size", {script.width, script.height}},
+                   {"script", scriptPath.empty() ? "builtin" : scriptPath},
+                   {"frames_per_pass", frames.size()},
+                   {"passes", repeat},
+                   {"rasterizer", modeName},
+                   {"edge_source", edgeSource == Mesh::UNIQUE_EDGES ? "unique_edges" : "face_polygons"},
+                   {"raster_threads", threadCount},
+                   {"gl", glInfo},
+                   {"stages",
+                    {{"projection", stageStats(projectMs)},
+                     {"clipping", stageStats(clipMs)},
+                     {"rasterization", stageStats(rasterMs)},
+                     {"upload", stageStats(uploadMs)},
+                     {"draw", stageStats(drawMs)},
+                     {"total", stageStats(totalMs)}}},
+                   {"segments_per_frame", segmentSum / timedFrames},
+                   {"points_per_frame", pointSum / timedFrames},
+                   {"empty_frames", emptyFrames},
+                   {"deterministic", deterministic}};
+    // A scene that is never on screen times nothing worth comparing
+    const bool visible = emptyFrames < timedFrames;
+
+    // With --json - the JSON owns stdout and the table goes to stderr
+    FILE* table = jsonPath == "-" ? stderr : stdout;
+    std::fprintf(table, "%zu mesh(es), %zu frames x %d passes, %s, %u raster thread(s)%s\n", meshes.size(), frames.size(), repeat,
+                modeName, threadCount, useGL ? ", GL upload + draw" : "");
+    for (const char* stage : {"projection", "clipping", "rasterization", "upload", "draw", "total"}) {
+        const json& s = result["stages"][stage];
+        if (s.is_null()) continue;
+        std::fprintf(table, "  %-14s p50 %8.3f ms  p95 %8.3f ms  p99 %8.3f ms  mean %8.3f ms\n", stage, s["p50_ms"].get<double>(),
+                    s["p95_ms"].get<double>(), s["p99_ms"].get<double>(), s["mean_ms"].get<double>());
+    }
+    std::fprintf(table, "  %.0f segments, %.0f points per frame, %zu empty frames; replay %s\n", segmentSum / timedFrames,
+                pointSum / timedFrames, emptyFrames, deterministic ? "deterministic" : "MISMATCH");
+    if (!visible) std::fprintf(stderr, "Every frame was clipped away: the script never shows the meshes\n");
+
+    if (jsonPath == "-") {
+        std::printf("%s\n", result.dump(2).c_str());
+    } else if (!jsonPath.empty()) {
+        std::ofstream out(jsonPath);
+        if (!out.is_open()) {
+            std::fprintf(stderr, "Failed to write %s\n", jsonPath.c_str());
+            return 1;
+        }
+        out << result.dump(2) << "\n";
+    }
+
+    if (window) {
+        gpuPool.destroy();
+        shader.reset();
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+    return deterministic && visible ? 0 : 1;
+}
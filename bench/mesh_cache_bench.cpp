@@ -0,0 +1,122 @@
+// Mesh start-up time: OBJ parse + half-edge build versus restoring the
+// binary cache written next to the source file.
+//
+// Correctness: the restored mesh must equal the parsed one, and copies of
+// the cache with a truncated tail or a huge count in any header field
+// (sized so count * element size wraps to a few bytes) must be rejected.
+//
+// Usage: mesh_cache_bench [file.obj] [--scale N] [--runs N] [--threads N]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "mesh.hpp"
+#include "mesh_cache.hpp"
+
+namespace {
+
+// True if readMeshCache rejects every corrupted copy of the cache file
+bool rejectsCorruptCaches(const std::string& cachePath, const std::string& sourcePath) {
+    std::ifstream in(cachePath, std::ios::binary);
+    const std::vector<char> original((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const std::string corruptPath = "mesh_cache_bench_corrupt.cgmc";
+    auto rejected = [&](const std::vector<char>& bytes) {
+        {
+            std::ofstream out(corruptPath, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+        Mesh mesh(sourcePath);
+        return !readMeshCache(corruptPath, sourcePath, mesh);
+    };
+
+    bool ok = original.size() > 80 && !rejected(original);
+    // Truncated: the last section runs past the end of the file
+    ok = ok && rejected(std::vector<char>(original.begin(), original.end() - 8));
+    // vertex, face, face index, half-edge and edge counts follow magic, version,
+    // header size, source size, mtime and hash; 2^62 times 4, 8 or 12 is 0 mod 2^64
+    for (size_t field = 40; field <= 72 && ok; field += 8) {
+        std::vector<char> bytes = original;
+        const uint64_t huge = 1ull << 62;
+        std::memcpy(bytes.data() + field, &huge, sizeof(huge));
+        ok = rejected(bytes);
+    }
+    std::remove(corruptPath.c_str());
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int scale = 200;
+    int runs = 3;
+    unsigned threads = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--scale") && i + 1 < argc) scale = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) threads = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    ObjMeshData source;
+    if (!loadOBJ(input, source)) return 1;
+    const std::string scaled = "mesh_cache_bench_scaled.obj";
+    const std::string cachePath = meshCachePathFor(scaled);
+    if (!bench::writeScaledOBJ(source, scale, scaled)) {
+        std::cerr << "Could not write " << scaled << std::endl;
+        return 1;
+    }
+    std::printf("%s x%d: %.1f MB\n", input.c_str(), scale, bench::fileMegabytes(scaled));
+
+    MeshLoadOptions rebuild;
+    rebuild.threads = threads;
+    rebuild.rebuildCache = true;
+    MeshLoadOptions cached;
+    cached.threads = threads;
+
+    double bestParse = 1e30, bestWrite = 1e30, bestCache = 1e30;
+    bool same = true;
+    for (int r = 0; r < runs; ++r) {
+        auto start = bench::Clock::now();
+        Mesh parsed(scaled);
+        parsed.loadFromOBJ(scaled, threads);
+        parsed.buildHalfEdge();
+        bestParse = std::min(bestParse, bench::secondsSince(start));
+
+        // Parse + build + write, as on a first launch
+        start = bench::Clock::now();
+        Mesh written(scaled);
+        written.load(scaled, rebuild);
+        bestWrite = std::min(bestWrite, bench::secondsSince(start));
+
+        start = bench::Clock::now();
+        Mesh restored(scaled);
+        if (!restored.load(scaled, cached)) {
+            std::cerr << "Cache load failed" << std::endl;
+            return 1;
+        }
+        bestCache = std::min(bestCache, bench::secondsSince(start));
+
+        same = same && restored.halfEdgeMesh.twin == parsed.halfEdgeMesh.twin &&
+               restored.edge_indices == parsed.edge_indices &&
+               restored.face_indices.indices == parsed.face_indices.indices;
+    }
+    std::printf("cache file: %.1f MB\n", bench::fileMegabytes(cachePath));
+    const bool rejects = rejectsCorruptCaches(cachePath, scaled);
+    std::remove(scaled.c_str());
+    std::remove(cachePath.c_str());
+
+    std::printf("parse + build half-edge:         %8.3f s\n", bestParse);
+    std::printf("parse + build + write cache:     %8.3f s\n", bestWrite);
+    std::printf("load from cache:                 %8.3f s  (%.1fx faster than parse + build)  %s\n",
+                bestCache, bestParse / bestCache, same ? "identical" : "MISMATCH");
+    std::printf("corrupt caches (truncated, huge counts): %s\n", rejects ? "rejected" : "ACCEPTED");
+    return same && rejects ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+// Close-up views: the camera flies from outside the mesh into it, so the
+// near plane sweeps through the mesh and edges and faces cross it. For each step the
+// unique edges go through Mesh::clipToViewport() and the faces through
+// Mesh::clipFacesToViewport(); the report shows how many edges the frustum
+// outcodes reject before any 2D work, how many cross the near or far plane
+// and are clipped in clip space (the old path skipped every edge with a
+// vertex behind the camera), and the time per frame.
+//
+// Correctness: every output end point is finite and inside the viewport,
+// and clipEdgeToFrustum() matches a double-precision clip-space reference
+// on every edge crossing a depth plane (within 1e-3 of the coordinate
+// magnitude, as near-plane points can be far off screen).
+//
+// Usage: near_clip_bench [file.obj] [--levels N] [--frames N]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "mesh.hpp"
+
+namespace {
+
+struct ScreenPoint {
+    double x, y;
+};
+
+// Reference for one edge: clip [0, 1] against z + w >= 0 and w - z >= 0 in double
+bool referenceClip(const glm::mat4& mvp, const Point& pa, const Point& pb, int width, int height, ScreenPoint& a, ScreenPoint& b) {
+    const glm::vec4 fa = mvp * glm::vec4(pa.x, pa.y, pa.z, 1.0f), fb = mvp * glm::vec4(pb.x, pb.y, pb.z, 1.0f);
+    const double ca[4] = {fa.x, fa.y, fa.z, fa.w}, cb[4] = {fb.x, fb.y, fb.z, fb.w};
+    double t0 = 0.0, t1 = 1.0;
+    const double near[2] = {ca[2] + ca[3], cb[2] + cb[3]}, far[2] = {ca[3] - ca[2], cb[3] - cb[2]};
+    for (const double* d : {near, far}) {
+        if (d[0] < 0.0 && d[1] < 0.0) return false;
+        if (d[0] < 0.0) t0 = std::max(t0, d[0] / (d[0] - d[1]));
+        else if (d[1] < 0.0) t1 = std::min(t1, d[0] / (d[0] - d[1]));
+    }
+    if (t0 >= t1) return false;
+    auto screen = [&](double t) {
+        double c[4];
+        for (int k = 0; k < 4; ++k) c[k] = ca[k] + (cb[k] - ca[k]) * t;
+        return ScreenPoint{(c[0] / c[3] + 1.0) * 0.5 * width, (1.0 - c[1] / c[3]) * 0.5 * height};
+    };
+    a = screen(t0);
+    b = screen(t1);
+    return true;
+}
+
+double relativeError(const ScreenPoint& reference, const glm::vec2& value) {
+    const double scale = std::max({1.0, std::abs(reference.x), std::abs(reference.y)});
+    return std::max(std::abs(reference.x - value.x), std::abs(reference.y - value.y)) / scale;
+}
+
+bool insideViewport(const glm::vec2& p, const ViewportRect& vp) {
+    const float eps = 1e-3f;
+    return std::isfinite(p.x) && std::isfinite(p.y) && p.x >= vp.x_min - eps && p.x <= vp.x_max + eps &&
+           p.y >= vp.y_min - eps && p.y <= vp.y_max + eps;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 3;
+    int frameCount = 8;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    Mesh mesh(input);
+    if (!bench::loadMesh(input, levels, mesh)) return 1;
+    std::printf("%s subdivided %d times: %zu vertices, %zu unique edges, %zu faces, 1080x1080\n", input.c_str(), levels,
+                mesh.points.size(), mesh.edge_indices.size(), mesh.face_indices.size());
+
+    const bench::Frame start = bench::orbitFrames(mesh.points, 1, 1080, 1080)[0];
+    const float startZ = start.view[3][2];
+    bool ok = true;
+    for (int step = 0; step < frameCount; ++step) {
+        // From the orbit distance until the near plane has swept most of the mesh
+        bench::Frame f = start;
+        f.view[3][2] = startZ * (1.0f - 0.6f * step / std::max(1, frameCount - 1));
+        const ProjectedVertices& screen = mesh.projectToScreenSpace(f.model, f.view, f.projection, f.width, f.height);
+        const glm::mat4 mvp = f.projection * f.view * f.model;
+
+        size_t rejected = 0, depthCrossing = 0;
+        double worst = 0.0;
+        for (const auto& edge : mesh.edge_indices) {
+            const uint8_t a = screen.clipCodes[edge.first], b = screen.clipCodes[edge.second];
+            if (a & b) {
+                ++rejected;
+                continue;
+            }
+            if (!((a | b) & CLIP_DEPTH)) continue;
+            ++depthCrossing;
+            glm::vec2 sa, sb;
+            ScreenPoint ra, rb;
+            const bool kept = clipEdgeToFrustum(mesh.positionsSoA, screen, edge.first, edge.second, sa, sb);
+            const bool expected = referenceClip(mvp, mesh.points[edge.first], mesh.points[edge.second], f.width, f.height, ra, rb);
+            if (kept != expected) {
+                worst = 1.0;
+                continue;
+            }
+            if (kept) worst = std::max({worst, relativeError(ra, sa), relativeError(rb, sb)});
+        }
+
+        auto time = bench::Clock::now();
+        const Mesh::ClipResult edges = mesh.clipToViewport(screen, f.viewport);
+        const double edgeMs = bench::secondsSince(time) * 1000.0;
+        time = bench::Clock::now();
+        const Mesh::ClipResult faces = mesh.clipFacesToViewport(screen, f.viewport);
+        const double faceMs = bench::secondsSince(time) * 1000.0;
+
+        size_t outside = 0;
+        for (const Mesh::ClipResult* result : {&edges, &faces}) {
+            for (const auto* list : {&result->visibleEdges, &result->boundarySegments}) {
+                for (const auto& seg : *list) outside += !insideViewport(seg.first, f.viewport) || !insideViewport(seg.second, f.viewport);
+            }
+        }
+        const size_t beyondNear = std::count_if(screen.clipCodes.begin(), screen.clipCodes.end(), [](uint8_t c) { return c & CLIP_NEAR; });
+        const bool pass = outside == 0 && worst <= 1e-3;
+        ok = ok && pass;
+        std::printf("camera z %6.3f: %6.1f%% vertices beyond near | edges: %6.1f%% frustum-rejected, %6zu cross near/far, "
+                    "%7zu drawn, %6.2f ms | faces: %6zu depth-clipped, %7zu drawn, %6.2f ms | max error %.1e  %s\n",
+                    f.view[3][2], 100.0 * beyondNear / screen.size(), 100.0 * rejected / mesh.edge_indices.size(),
+                    depthCrossing, edges.visibleEdges.size() + edges.boundarySegments.size(), edgeMs,
+                    mesh.clippedFaces.depthClips, mesh.clippedFaces.size(), faceMs, worst, pass ? "ok" : "MISMATCH");
+    }
+    return ok ? 0 : 1;
+}
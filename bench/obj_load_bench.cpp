@@ -0,0 +1,107 @@
+// OBJ loading throughput: stream-based loadOBJPoints/loadOBJFaces versus
+// the single-pass memory-mapped loadOBJ.
+//
+// Usage: obj_load_bench [file.obj] [--scale N] [--runs N] [--threads N]
+//
+// After the serial comparison the parallel parser is timed with 1, 2, 4, ...
+// threads up to --threads (default: all hardware threads) and its output is
+// checked against the serial result.
+// The input mesh is replicated N times (each copy shifted along x) into a
+// temporary file so the measurement reflects large scans rather than the
+// page cache warm-up of a tiny file.
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "obj_loader.hpp"
+#include "thread_pool.hpp"
+#include "utils.hpp"
+
+namespace {
+
+bool sameGeometry(const ObjMeshData& a, const ObjMeshData& b) {
+    if (a.points.size() != b.points.size()) return false;
+    for (size_t i = 0; i < a.points.size(); ++i) {
+        if (std::memcmp(&a.points[i], &b.points[i], sizeof(Point)) != 0) return false;
+    }
+    return a.faces.offsets == b.faces.offsets && a.faces.indices == b.faces.indices;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int scale = 200;
+    int runs = 3;
+    unsigned maxThreads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--scale") && i + 1 < argc) scale = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--runs") && i + 1 < argc) runs = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) maxThreads = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    ObjMeshData source;
+    if (!loadOBJ(input, source)) return 1;
+
+    const std::string scaled = "obj_load_bench_scaled.obj";
+    if (!bench::writeScaledOBJ(source, scale, scaled)) {
+        std::cerr << "Could not write " << scaled << std::endl;
+        return 1;
+    }
+    const double megabytes = bench::fileMegabytes(scaled);
+    std::printf("%s x%d: %.1f MB, %zu vertices, %zu faces\n",
+                input.c_str(), scale, megabytes, source.points.size() * scale, source.faces.size() * scale);
+
+    double bestStream = 1e30, bestMapped = 1e30;
+    size_t streamFaces = 0, mappedFaces = 0;
+    for (int r = 0; r < runs; ++r) {
+        auto start = bench::Clock::now();
+        std::vector<Point> points = loadOBJPoints(scaled);
+        std::vector<std::vector<int>> faces = loadOBJFaces(scaled);
+        bestStream = std::min(bestStream, bench::secondsSince(start));
+        streamFaces = faces.size();
+
+        start = bench::Clock::now();
+        ObjMeshData data;
+        loadOBJ(scaled, data);
+        bestMapped = std::min(bestMapped, bench::secondsSince(start));
+        mappedFaces = data.faces.size();
+    }
+
+    if (streamFaces != mappedFaces) {
+        std::cerr << "Face count mismatch: " << streamFaces << " vs " << mappedFaces << std::endl;
+        std::remove(scaled.c_str());
+        return 1;
+    }
+    std::printf("loadOBJPoints+loadOBJFaces: %8.3f s  %8.1f MB/s\n", bestStream, megabytes / bestStream);
+    std::printf("loadOBJ (mmap, one pass):   %8.3f s  %8.1f MB/s  (%.1fx)\n",
+                bestMapped, megabytes / bestMapped, bestStream / bestMapped);
+
+    // Thread scaling of the chunked parser
+    ObjMeshData serial;
+    loadOBJ(scaled, serial, 1);
+    maxThreads = ThreadPool::resolveThreadCount(maxThreads);
+    bool identical = true;
+    for (unsigned threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+        double best = 1e30;
+        ObjMeshData data;
+        for (int r = 0; r < runs; ++r) {
+            auto start = bench::Clock::now();
+            loadOBJ(scaled, data, threads);
+            best = std::min(best, bench::secondsSince(start));
+        }
+        bool same = sameGeometry(serial, data);
+        identical = identical && same;
+        std::printf("loadOBJ %2u threads:         %8.3f s  %8.1f MB/s  %s\n",
+                    threads, best, megabytes / best, same ? "identical" : "MISMATCH");
+        if (threads == maxThreads) break;
+    }
+    std::remove(scaled.c_str());
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+// Screen projection throughput in vertices/s: the per-vertex path the
+// viewer used before (model multiply, projectWorldToScreen, push_back into
+// a fresh vector) versus projectPositions() with each kernel. Every kernel
+// is checked against the old path and its frustum outcodes against glm,
+// including a frame with the camera inside the mesh so that the near-plane
+// bit is exercised.
+//
+// Usage: projection_bench [file.obj] [--levels N] [--frames N]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "projection.hpp"
+#include "utils.hpp"
+
+namespace {
+
+std::vector<glm::vec2> projectPerVertex(const std::vector<Point>& points, const bench::Frame& f) {
+    std::vector<glm::vec2> projected;
+    for (const auto& v : points) {
+        glm::vec3 world = glm::vec3(f.model * glm::vec4(v.x, v.y, v.z, 1.0f));
+        projected.push_back(projectWorldToScreen(world, f.view, f.projection, f.width, f.height));
+    }
+    return projected;
+}
+
+// Frustum outcode from clip coordinates computed by glm; bits whose plane is
+// within a relative 1e-5 of the vertex are returned in `ambiguous`
+uint8_t referenceCode(const glm::vec4& c, uint8_t& ambiguous) {
+    const float eps = 1e-5f * (std::abs(c.w) + std::abs(c.z) + 1.0f);
+    const float d[6] = {c.x + c.w, c.w - c.x, c.y + c.w, c.w - c.y, c.z + c.w, c.w - c.z};
+    const uint8_t bits[6] = {CLIP_LEFT, CLIP_RIGHT, CLIP_BOTTOM, CLIP_TOP, CLIP_NEAR, CLIP_FAR};
+    uint8_t code = 0;
+    ambiguous = 0;
+    for (int p = 0; p < 6; ++p) {
+        if (d[p] < 0.0f) code |= bits[p];
+        if (std::abs(d[p]) < eps) ambiguous |= bits[p];
+    }
+    return code;
+}
+
+// Largest screen-space difference in pixels, or -1 if the outcodes disagree
+double compare(const std::vector<Point>& points, const bench::Frame& f, const std::vector<glm::vec2>& reference,
+               const ProjectedVertices& out) {
+    const glm::mat4 mvp = f.projection * f.view * f.model;
+    double worst = 0.0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+        uint8_t ambiguous;
+        const uint8_t code = referenceCode(mvp * glm::vec4(points[i].x, points[i].y, points[i].z, 1.0f), ambiguous);
+        if ((code ^ out.clipCodes[i]) & ~ambiguous) return -1.0;
+        if (!out.visible(i) || (ambiguous & CLIP_NEAR)) continue;
+        // Relative to the magnitude: near the camera plane coordinates get huge
+        const double scale = std::max(1.0, double(std::max(std::abs(reference[i].x), std::abs(reference[i].y))) / 1000.0);
+        worst = std::max(worst, std::abs(double(reference[i].x) - out.screen[i].x) / scale);
+        worst = std::max(worst, std::abs(double(reference[i].y) - out.screen[i].y) / scale);
+    }
+    return worst;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 4;
+    int frameCount = 30;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    ObjMeshData data;
+    if (!bench::loadSubdivided(input, levels, data)) return 1;
+    const size_t n = data.points.size();
+    std::printf("%s subdivided %d times: %zu vertices, %d frames, best kernel %s\n", input.c_str(), levels, n,
+                frameCount, projectionKernelName(ProjectionKernel::Auto));
+
+    std::vector<bench::Frame> frames = bench::orbitFrames(data.points, frameCount, 1080, 1080);
+    // Camera inside the mesh with the near plane (0.1) through its centre:
+    // roughly half of the vertices are beyond it
+    bench::Frame inside = frames[0];
+    inside.view[3][2] = -0.1f;
+
+    SoAPositions positions;
+    positions.assign(data.points);
+
+    size_t sink = 0;
+    auto start = bench::Clock::now();
+    for (const bench::Frame& f : frames) sink += projectPerVertex(data.points, f).size();
+    const double reference = bench::secondsSince(start);
+    std::printf("%-22s %8.2f M vertices/s\n", "per vertex (old path)", n * frames.size() / reference * 1e-6);
+
+    bool ok = true;
+    const ProjectionKernel kernels[] = {ProjectionKernel::Scalar, ProjectionKernel::SSE, ProjectionKernel::AVX2};
+    for (ProjectionKernel kernel : kernels) {
+        if (kernel == ProjectionKernel::AVX2 && bestProjectionKernel() != ProjectionKernel::AVX2) continue;
+        ProjectedVertices out;
+        projectPositions(positions, frames[0].projection * frames[0].view * frames[0].model, 1080, 1080, out, kernel);
+        start = bench::Clock::now();
+        for (const bench::Frame& f : frames) {
+            projectPositions(positions, f.projection * f.view * f.model, f.width, f.height, out, kernel);
+            sink += out.clipCodes[0];
+        }
+        const double seconds = bench::secondsSince(start);
+
+        double worst = 0.0;
+        for (const bench::Frame* f : {&frames[0], &frames[frames.size() / 2], &inside}) {
+            projectPositions(positions, f->projection * f->view * f->model, f->width, f->height, out, kernel);
+            const double error = compare(data.points, *f, projectPerVertex(data.points, *f), out);
+            worst = error < 0 || worst < 0 ? -1.0 : std::max(worst, error);
+        }
+        const size_t behind = std::count_if(out.clipCodes.begin(), out.clipCodes.end(), [](uint8_t c) { return c & CLIP_NEAR; });
+        const bool pass = worst >= 0 && worst < 0.01;
+        ok = ok && pass;
+        std::printf("%-22s %8.2f M vertices/s  %6.1fx  max error %.2e px  (%zu beyond near plane)  %s\n",
+                    projectionKernelName(kernel), n * frames.size() / seconds * 1e-6, reference / seconds, worst,
+                    behind, pass ? "ok" : "MISMATCH");
+    }
+    return ok && sink ? 0 : 1;
+}
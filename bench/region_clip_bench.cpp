@@ -0,0 +1,217 @@
+// Weiler-Atherton clipping against concave lasso regions in faces/s. The
+// clip regions are jagged stars centred on a 1080x1080 screen with 8 to
+// 2048 vertices; each is timed with its edge grid and with the grid
+// disabled (gridSize 1, every edge tested). Subjects are the projected
+// triangles of a turntable scene and concave 16-point stars scattered over
+// the screen, which cross the region many times and split into pieces.
+// Mesh::clipToRegion() is timed on the unique edges as well.
+//
+// Correctness: grid and brute force must produce identical pieces; sampled
+// points (away from both boundaries) must lie in some piece exactly when
+// they lie in both subject and region; for edges, piece midpoints must be
+// inside the region and the gaps between pieces outside.
+//
+// Usage: region_clip_bench [file.obj] [--levels N] [--frames N]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "mesh.hpp"
+#include "weiler-atherton-clip.hpp"
+
+namespace {
+
+// Star with alternating outer/inner radius, jittered so no two spikes match
+WA_Polygon makeStar(float cx, float cy, float radius, int vertices, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> jitter(0.85f, 1.0f);
+    WA_Polygon star;
+    for (int i = 0; i < vertices; ++i) {
+        const float angle = 6.2831853f * i / vertices;
+        const float r = radius * (i % 2 ? 0.55f : 1.0f) * jitter(rng);
+        star.emplace_back(cx + r * std::cos(angle), cy + r * std::sin(angle));
+    }
+    return star;
+}
+
+bool polygonContains(const WA_Polygon& poly, float x, float y) {
+    bool inside = false;
+    for (size_t i = 0, n = poly.size(); i < n; ++i) {
+        const WA_Point& a = poly[i];
+        const WA_Point& b = poly[(i + 1) % n];
+        if ((a.y > y) != (b.y > y) && x < a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)) inside = !inside;
+    }
+    return inside;
+}
+
+float segmentDistance(const WA_Point& p, const WA_Point& a, const WA_Point& b) {
+    const float dx = b.x - a.x, dy = b.y - a.y;
+    const float len2 = dx * dx + dy * dy;
+    const float t = len2 > 0.0f ? std::max(0.0f, std::min(1.0f, ((p.x - a.x) * dx + (p.y - a.y) * dy) / len2)) : 0.0f;
+    const float ex = a.x + t * dx - p.x, ey = a.y + t * dy - p.y;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+bool nearBoundary(const WA_Polygon& poly, const WA_Point& p, float tolerance) {
+    for (size_t i = 0, n = poly.size(); i < n; ++i) {
+        if (segmentDistance(p, poly[i], poly[(i + 1) % n]) < tolerance) return true;
+    }
+    return false;
+}
+
+bool samePieces(const std::vector<WA_Polygon>& a, const std::vector<WA_Polygon>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t p = 0; p < a.size(); ++p) {
+        if (a[p].size() != b[p].size()) return false;
+        for (size_t k = 0; k < a[p].size(); ++k) {
+            if (a[p][k].x != b[p][k].x || a[p][k].y != b[p][k].y) return false;
+        }
+    }
+    return true;
+}
+
+// Sampled membership: in a piece <=> in subject and in region; returns the number of wrong samples
+size_t membershipErrors(const WA_Polygon& subject, const WA_Polygon& region, const std::vector<WA_Polygon>& pieces,
+                        std::mt19937& rng, int samples) {
+    float x0 = subject[0].x, x1 = x0, y0 = subject[0].y, y1 = y0;
+    for (const WA_Point& p : subject) {
+        x0 = std::min(x0, p.x);
+        x1 = std::max(x1, p.x);
+        y0 = std::min(y0, p.y);
+        y1 = std::max(y1, p.y);
+    }
+    std::uniform_real_distribution<float> x(x0, x1), y(y0, y1);
+    size_t errors = 0;
+    for (int s = 0; s < samples; ++s) {
+        const WA_Point p(x(rng), y(rng));
+        if (nearBoundary(subject, p, 0.05f) || nearBoundary(region, p, 0.05f)) continue;
+        const bool expected = polygonContains(subject, p.x, p.y) && polygonContains(region, p.x, p.y);
+        bool inPiece = false;
+        for (const WA_Polygon& piece : pieces) inPiece = inPiece || polygonContains(piece, p.x, p.y);
+        errors += inPiece != expected;
+    }
+    return errors;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 1;
+    int frameCount = 3;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    Mesh mesh(input);
+    if (!bench::loadMesh(input, levels, mesh)) return 1;
+    const std::vector<bench::Frame> frames = bench::orbitFrames(mesh.points, frameCount, 1080, 1080);
+
+    // Subjects: visible projected triangles of every frame, then scattered stars
+    std::vector<WA_Polygon> triangles;
+    std::vector<ProjectedVertices> projected(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const bench::Frame& f = frames[i];
+        projected[i] = mesh.projectToScreenSpace(f.model, f.view, f.projection, f.width, f.height);
+        const ProjectedVertices& screen = projected[i];
+        for (size_t face = 0; face < mesh.face_indices.size(); ++face) {
+            const int* v = mesh.face_indices.face(face);
+            WA_Polygon poly;
+            bool visible = true;
+            for (int k = 0; k < mesh.face_indices.faceSize(face) && visible; ++k) {
+                visible = screen.visible(v[k]);
+                poly.emplace_back(screen.screen[v[k]].x, screen.screen[v[k]].y);
+            }
+            if (visible) triangles.push_back(std::move(poly));
+        }
+    }
+    std::vector<WA_Polygon> stars;
+    std::mt19937 placement(5);
+    std::uniform_real_distribution<float> centre(100.0f, 980.0f);
+    for (int i = 0; i < 200; ++i) stars.push_back(makeStar(centre(placement), centre(placement), 120.0f, 32, 100 + i));
+    std::printf("%s subdivided %d times: %zu projected triangles over %d frames, %zu 16-point stars, %zu unique edges\n",
+                input.c_str(), levels, triangles.size(), frameCount, stars.size(), mesh.edge_indices.size());
+
+    bool ok = true;
+    std::mt19937 sampler(11);
+    for (int vertices : {8, 64, 512, 2048}) {
+        const WA_Polygon lasso = makeStar(540.0f, 540.0f, 420.0f, vertices, vertices);
+        const WA_ClipRegion grid(lasso);
+        const WA_ClipRegion brute(lasso, 1);
+        std::printf("region %4d vertices (grid %dx%d):\n", vertices, grid.gridSize(), grid.gridSize());
+
+        auto run = [&](const char* label, const std::vector<WA_Polygon>& subjects) {
+            std::vector<std::vector<WA_Polygon>> gridPieces(subjects.size());
+            size_t pieces = 0;
+            auto start = bench::Clock::now();
+            for (size_t s = 0; s < subjects.size(); ++s) {
+                gridPieces[s] = weiler_atherton_clip(subjects[s], grid);
+                pieces += gridPieces[s].size();
+            }
+            const double gridSeconds = bench::secondsSince(start);
+
+            size_t differences = 0;
+            start = bench::Clock::now();
+            for (size_t s = 0; s < subjects.size(); ++s) {
+                differences += !samePieces(weiler_atherton_clip(subjects[s], brute), gridPieces[s]);
+            }
+            const double bruteSeconds = bench::secondsSince(start);
+
+            // Sample a subset so the reference check stays cheap on large regions
+            size_t errors = 0;
+            const size_t stride = std::max<size_t>(1, subjects.size() / 200);
+            for (size_t s = 0; s < subjects.size(); s += stride) {
+                errors += membershipErrors(subjects[s], grid.boundary(), gridPieces[s], sampler, 64);
+            }
+            const bool pass = differences == 0 && errors == 0;
+            ok = ok && pass;
+            std::printf("  %-10s grid %8.3f M faces/s | brute %8.3f M faces/s %6.1fx | %7zu pieces | "
+                        "%zu grid/brute differences, %zu sample errors  %s\n",
+                        label, subjects.size() / gridSeconds * 1e-6, subjects.size() / bruteSeconds * 1e-6,
+                        bruteSeconds / gridSeconds, pieces, differences, errors, pass ? "ok" : "MISMATCH");
+        };
+        run("triangles", triangles);
+        run("stars", stars);
+
+        // Unique edges through Mesh::clipToRegion(), then the gap/piece midpoint check
+        size_t edgePieces = 0;
+        auto start = bench::Clock::now();
+        for (const ProjectedVertices& screen : projected) edgePieces += mesh.clipToRegion(screen, grid).visibleEdges.size();
+        const double edgeSeconds = bench::secondsSince(start);
+
+        size_t edgeErrors = 0;
+        std::vector<std::pair<WA_Point, WA_Point>> pieces;
+        const ProjectedVertices& screen = projected[0];
+        for (size_t e = 0; e < mesh.edge_indices.size(); e += 7) {
+            const glm::vec2 a = screen.screen[mesh.edge_indices[e].first], b = screen.screen[mesh.edge_indices[e].second];
+            const WA_Point pa(a.x, a.y), pb(b.x, b.y);
+            pieces.clear();
+            weiler_atherton_clip_segment(pa, pb, grid, pieces);
+            auto expect = [&](const WA_Point& p, const WA_Point& q, bool inside) {
+                const WA_Point mid(0.5f * (p.x + q.x), 0.5f * (p.y + q.y));
+                if ((p.x == q.x && p.y == q.y) || nearBoundary(lasso, mid, 0.05f)) return;
+                edgeErrors += polygonContains(lasso, mid.x, mid.y) != inside;
+            };
+            WA_Point cursor = pa;
+            for (const auto& piece : pieces) {
+                expect(cursor, piece.first, false);
+                expect(piece.first, piece.second, true);
+                cursor = piece.second;
+            }
+            expect(cursor, pb, false);
+        }
+        ok = ok && edgeErrors == 0;
+        std::printf("  %-10s grid %8.3f M edges/s | %7zu pieces | %zu midpoint errors  %s\n", "edges",
+                    mesh.edge_indices.size() * projected.size() / edgeSeconds * 1e-6, edgePieces, edgeErrors,
+                    edgeErrors ? "MISMATCH" : "ok");
+    }
+    return ok ? 0 : 1;
+}
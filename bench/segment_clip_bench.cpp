@@ -0,0 +1,221 @@
+// Segment clipping in M segments/s: weiler_atherton_clip() on 2-point
+// polygons, the per-edge Liang-Barsky loop Mesh::clipToViewport used
+// before, and clipSegments() with each kernel. Inputs are the projected
+// unique edges of a turntable scene plus random segments scattered around
+// the viewport (many crossing a side or a corner, some parallel to a side).
+//
+// Correctness: every kernel must classify each segment exactly like the
+// scalar clipper and produce the same end points (within 1e-4 px); the
+// scalar clipper must agree with the old Liang-Barsky loop and with
+// weiler_atherton_clip() on which segments survive and where they end
+// (within 1e-2 px, since Weiler-Atherton intersects with a different formula).
+//
+// Usage: segment_clip_bench [file.obj] [--levels N] [--frames N]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "mesh.hpp"
+#include "segment_clip.hpp"
+#include "weiler-atherton-clip.hpp"
+
+namespace {
+
+// The Liang-Barsky clipper Mesh::clipToViewport used before this module existed
+bool clipLiangBarskyOld(glm::vec2& a, glm::vec2& b, const WA_Viewport& vp) {
+    const glm::vec2 start = a;
+    const glm::vec2 d = b - a;
+    const float p[4] = {-d.x, d.x, -d.y, d.y};
+    const float q[4] = {a.x - vp.xmin, vp.xmax - a.x, a.y - vp.ymin, vp.ymax - a.y};
+    float t0 = 0.0f, t1 = 1.0f;
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0f) {
+            if (q[i] < 0.0f) return false;
+            continue;
+        }
+        const float t = q[i] / p[i];
+        if (p[i] < 0.0f) {
+            if (t > t1) return false;
+            t0 = std::max(t0, t);
+        } else {
+            if (t < t0) return false;
+            t1 = std::min(t1, t);
+        }
+    }
+    if (t0 > 0.0f) a = start + d * t0;
+    if (t1 < 1.0f) b = start + d * t1;
+    return true;
+}
+
+// Weiler-Atherton on a 2-point polygon; its output can repeat the
+// intersection points, so the clipped segment is the farthest pair
+bool clipWeilerAtherton(glm::vec2& a, glm::vec2& b, const WA_Viewport& vp) {
+    WA_ClipResult result = weiler_atherton_clip({WA_Point(a.x, a.y), WA_Point(b.x, b.y)}, vp);
+    if (result.clipped.empty()) return false;
+    float best = -1.0f;
+    for (const WA_Point& p : result.clipped) {
+        for (const WA_Point& q : result.clipped) {
+            const float d = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y);
+            if (d > best) {
+                best = d;
+                a = glm::vec2(p.x, p.y);
+                b = glm::vec2(q.x, q.y);
+            }
+        }
+    }
+    return true;
+}
+
+float distance(glm::vec2 a, glm::vec2 b) { return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y)); }
+
+// Largest end point distance, with the pair matched in either order
+float endpointError(glm::vec2 a0, glm::vec2 b0, glm::vec2 a1, glm::vec2 b1) {
+    return std::min(std::max(distance(a0, a1), distance(b0, b1)), std::max(distance(a0, b1), distance(b0, a1)));
+}
+
+void appendRandomSegments(SegmentBatch& batch, const WA_Viewport& vp, size_t count) {
+    std::mt19937 rng(99);
+    const float w = vp.xmax - vp.xmin, h = vp.ymax - vp.ymin;
+    std::uniform_real_distribution<float> x(vp.xmin - 0.5f * w, vp.xmax + 0.5f * w), y(vp.ymin - 0.5f * h, vp.ymax + 0.5f * h);
+    const size_t base = batch.size();
+    batch.resize(base + count);
+    for (size_t i = 0; i < count; ++i) {
+        float x0 = x(rng), y0 = y(rng), x1 = x(rng), y1 = y(rng);
+        if (i % 16 == 0) x1 = x0;                   // Vertical
+        if (i % 16 == 1) y1 = y0;                   // Horizontal
+        if (i % 16 == 2) x0 = x1 = vp.xmin;         // Along the left side
+        if (i % 16 == 3) { x1 = x0; y1 = y0; }      // Degenerate
+        batch.x0[base + i] = x0;
+        batch.y0[base + i] = y0;
+        batch.x1[base + i] = x1;
+        batch.y1[base + i] = y1;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 3;
+    int frameCount = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    Mesh mesh(input);
+    if (!bench::loadMesh(input, levels, mesh)) return 1;
+    const std::vector<bench::Frame> frames = bench::orbitFrames(mesh.points, frameCount, 1080, 1080);
+    const WA_Viewport vp{static_cast<float>(frames[0].viewport.x_min), static_cast<float>(frames[0].viewport.y_min),
+                         static_cast<float>(frames[0].viewport.x_max), static_cast<float>(frames[0].viewport.y_max)};
+
+    // Projected unique edges of every frame, then random segments
+    SegmentBatch segments;
+    for (const bench::Frame& f : frames) {
+        const ProjectedVertices& screen = mesh.projectToScreenSpace(f.model, f.view, f.projection, f.width, f.height);
+        const size_t base = segments.size();
+        segments.resize(base + mesh.edge_indices.size());
+        for (size_t i = 0; i < mesh.edge_indices.size(); ++i) {
+            const glm::vec2 a = screen.screen[mesh.edge_indices[i].first], b = screen.screen[mesh.edge_indices[i].second];
+            segments.x0[base + i] = a.x;
+            segments.y0[base + i] = a.y;
+            segments.x1[base + i] = b.x;
+            segments.y1[base + i] = b.y;
+        }
+    }
+    const size_t edgeSegments = segments.size();
+    appendRandomSegments(segments, vp, edgeSegments / 4 + 1000);
+    const size_t n = segments.size();
+    std::printf("%s subdivided %d times: %zu edge segments over %d frames + %zu random, best kernel %s\n",
+                mesh.name.c_str(), levels, edgeSegments, frameCount, n - edgeSegments,
+                segmentClipKernelName(SegmentClipKernel::Auto));
+
+    // Per-segment references
+    auto timeReference = [&](const char* label, bool (*clip)(glm::vec2&, glm::vec2&, const WA_Viewport&),
+                             std::vector<uint8_t>& keep, std::vector<glm::vec2>& ends) {
+        keep.assign(n, 0);
+        ends.assign(2 * n, glm::vec2(0.0f));
+        auto start = bench::Clock::now();
+        for (size_t i = 0; i < n; ++i) {
+            glm::vec2 a(segments.x0[i], segments.y0[i]), b(segments.x1[i], segments.y1[i]);
+            keep[i] = clip(a, b, vp);
+            ends[2 * i] = a;
+            ends[2 * i + 1] = b;
+        }
+        const double seconds = bench::secondsSince(start);
+        std::printf("%-24s %8.1f M segments/s\n", label, n / seconds * 1e-6);
+        return seconds;
+    };
+    std::vector<uint8_t> keepWA, keepOld;
+    std::vector<glm::vec2> endsWA, endsOld;
+    timeReference("weiler_atherton_clip", clipWeilerAtherton, keepWA, endsWA);
+    const double oldSeconds = timeReference("Liang-Barsky (old loop)", clipLiangBarskyOld, keepOld, endsOld);
+
+    bool ok = true;
+    SegmentBatch scalar;
+    const SegmentClipKernel kernels[] = {SegmentClipKernel::Scalar, SegmentClipKernel::SSE, SegmentClipKernel::AVX2};
+    for (SegmentClipKernel kernel : kernels) {
+        if (kernel == SegmentClipKernel::AVX2 && bestSegmentClipKernel() != SegmentClipKernel::AVX2) continue;
+        SegmentBatch batch = segments;
+        const int repeats = 5;
+        double seconds = 0.0;
+        for (int r = 0; r < repeats; ++r) {
+            batch = segments;
+            auto start = bench::Clock::now();
+            clipSegments(batch, vp, kernel);
+            seconds += bench::secondsSince(start);
+        }
+        seconds /= repeats;
+
+        if (kernel == SegmentClipKernel::Scalar) scalar = batch;
+        size_t classMismatches = 0;
+        float worst = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            if (batch.segmentClass[i] != scalar.segmentClass[i]) {
+                ++classMismatches;
+                continue;
+            }
+            if (batch.segmentClass[i] == SEGMENT_REJECTED) continue;
+            worst = std::max(worst, endpointError(glm::vec2(batch.x0[i], batch.y0[i]), glm::vec2(batch.x1[i], batch.y1[i]),
+                                                  glm::vec2(scalar.x0[i], scalar.y0[i]), glm::vec2(scalar.x1[i], scalar.y1[i])));
+        }
+        const bool pass = classMismatches == 0 && worst <= 1e-4f;
+        ok = ok && pass;
+        std::printf("%-24s %8.1f M segments/s  %5.1fx  vs scalar: %zu class mismatches, max %.1e px  %s\n",
+                    segmentClipKernelName(kernel), n / seconds * 1e-6, oldSeconds / seconds, classMismatches, worst,
+                    pass ? "ok" : "MISMATCH");
+    }
+
+    // Scalar clipper against both previous clippers
+    auto compare = [&](const char* label, const std::vector<uint8_t>& keep, const std::vector<glm::vec2>& ends, float tolerance) {
+        size_t keepMismatches = 0;
+        float worst = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            const bool kept = scalar.segmentClass[i] != SEGMENT_REJECTED;
+            if (kept != static_cast<bool>(keep[i])) {
+                // Outcode rejection also drops segments that only touch the viewport in one
+                // rounded point; the old clippers keep those as zero-length segments
+                if (keep[i] && distance(ends[2 * i], ends[2 * i + 1]) < 1e-3f) continue;
+                ++keepMismatches;
+                continue;
+            }
+            if (!kept) continue;
+            worst = std::max(worst, endpointError(glm::vec2(scalar.x0[i], scalar.y0[i]), glm::vec2(scalar.x1[i], scalar.y1[i]),
+                                                  ends[2 * i], ends[2 * i + 1]));
+        }
+        const bool pass = keepMismatches == 0 && worst <= tolerance;
+        ok = ok && pass;
+        std::printf("scalar vs %-24s %zu keep mismatches, max end point error %.1e px  %s\n", label, keepMismatches,
+                    worst, pass ? "ok" : "MISMATCH");
+    };
+    compare("Liang-Barsky (old loop)", keepOld, endsOld, 0.0f);
+    compare("weiler_atherton_clip", keepWA, endsWA, 1e-2f);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,242 @@
+// Per-frame upload of Wu points through StreamBuffer in each mode: the
+// single-region glBufferSubData path the viewer used before, unsynchronized
+// ring regions with orphaning (GL 3.3), and a persistently mapped ring with
+// fences (GL 4.4 / ARB_buffer_storage). Every frame uploads the points of a
+// turntable step and draws them as GL_POINTS from the returned offset, like
+// Mesh::drawRasterizedLines(). Reported per mode: CPU ms per frame (upload
+// plus draw submission), time blocked in waits, and upload MB/s.
+//
+// A second run draws a scene of several meshes through one GpuBufferPool,
+// each mesh streaming into its own sub-range of the shared buffer, and
+// compares the pool's GPU memory with the fixed 2M-point VBO every mesh
+// used to reserve.
+//
+// Correctness: after the run the last region is read back and compared
+// with the uploaded points, and the rendered image must be identical in
+// every mode; in the scene run every mesh's range must read back as its
+// points.
+//
+// Needs a GL 3.3 context; a hidden window is created. Without a GPU, run
+// it on Mesa's software renderer:
+//   LIBGL_ALWAYS_SOFTWARE=1 GALLIUM_DRIVER=llvmpipe xvfb-run -a ./stream_buffer_bench
+//
+// Usage: stream_buffer_bench [file.obj] [--levels N] [--frames N]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "gl_context.hpp"
+#include "gpu_buffer_pool.hpp"
+#include "mesh.hpp"
+#include "shader.hpp"
+#include "stream_buffer.hpp"
+
+namespace {
+
+const int kSize = 1080;
+// Points every mesh reserved on the GPU before the shared pool
+const size_t kFixedPointsPerMesh = 2000000;
+
+struct ModeResult {
+    double cpuMs = 0.0, waitMs = 0.0, megabytesPerSecond = 0.0;
+    bool readBackOk = false;
+    std::vector<unsigned char> image;
+};
+
+ModeResult runMode(StreamBuffer::Mode mode, Shader& shader, const std::vector<std::vector<WuVertex>>& frames, int rounds,
+                   const char*& name) {
+    ModeResult result;
+    StreamBuffer stream;
+    stream.init(sizeof(WuVertex), 1 << 16, mode);
+    name = stream.modeName();
+
+    unsigned int vao = 0, bound = 0;
+    glGenVertexArrays(1, &vao);
+    auto bindAttributes = [&] {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, stream.buffer());
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(WuVertex), (void*)offsetof(WuVertex, position));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(WuVertex), (void*)offsetof(WuVertex, color));
+        glEnableVertexAttribArray(1);
+        glBindVertexArray(0);
+        bound = stream.buffer();
+    };
+    bindAttributes();
+
+    shader.activate();
+    shader.setVec2("u_screenSize", glm::vec2(kSize, kSize));
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+
+    // One warm-up round grows the regions to the largest frame
+    size_t bytes = 0, first = 0;
+    const std::vector<WuVertex>* lastFrame = nullptr;
+    double seconds = 0.0;
+    for (int round = 0; round <= rounds; ++round) {
+        for (const std::vector<WuVertex>& points : frames) {
+            auto start = bench::Clock::now();
+            glClear(GL_COLOR_BUFFER_BIT);
+            first = stream.upload(points.data(), points.size());
+            if (stream.buffer() != bound) bindAttributes();
+            glBindVertexArray(vao);
+            glDrawArrays(GL_POINTS, static_cast<GLint>(first), static_cast<GLsizei>(points.size()));
+            glBindVertexArray(0);
+            stream.fence();
+            glFlush();
+            if (round == 0) continue;
+            seconds += bench::secondsSince(start);
+            result.waitMs += stream.lastUpload().waitMs;
+            bytes += stream.lastUpload().bytes;
+            lastFrame = &points;
+        }
+    }
+    glFinish();
+    const size_t frameCount = frames.size() * rounds;
+    result.cpuMs = seconds * 1000.0 / frameCount;
+    result.waitMs /= frameCount;
+    result.megabytesPerSecond = bytes / seconds * 1e-6;
+
+    // The region of the last frame must hold exactly its points
+    std::vector<WuVertex> readBack(lastFrame->size());
+    glBindBuffer(GL_ARRAY_BUFFER, stream.buffer());
+    glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(first * sizeof(WuVertex)),
+                       static_cast<GLsizeiptr>(readBack.size() * sizeof(WuVertex)), readBack.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    result.readBackOk = std::memcmp(readBack.data(), lastFrame->data(), readBack.size() * sizeof(WuVertex)) == 0;
+
+    result.image.resize(static_cast<size_t>(kSize) * kSize * 4);
+    glReadPixels(0, 0, kSize, kSize, GL_RGBA, GL_UNSIGNED_BYTE, result.image.data());
+
+    glDisable(GL_BLEND);
+    glDeleteVertexArrays(1, &vao);
+    stream.destroy();
+    return result;
+}
+
+// Draws meshCount turntable copies per frame through one pool; false if a range reads back wrong
+bool runScene(Shader& shader, const Mesh& mesh, const std::vector<std::vector<WuVertex>>& frames, int meshCount, int rounds) {
+    GpuBufferPool pool;
+    if (!pool.init()) return false;
+    // Each copy also holds the static position and edge buffers of the hardware modes
+    for (int m = 0; m < meshCount; ++m) {
+        pool.createStatic(GL_ARRAY_BUFFER, mesh.points.data(), mesh.points.size() * sizeof(Point));
+        pool.createStatic(GL_ELEMENT_ARRAY_BUFFER, mesh.edge_indices.data(), mesh.edge_indices.size() * sizeof(mesh.edge_indices[0]));
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    shader.activate();
+    shader.setVec2("u_screenSize", glm::vec2(kSize, kSize));
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    std::vector<GpuBufferPool::Range> ranges(meshCount);
+    std::vector<const std::vector<WuVertex>*> sources(meshCount);
+    double seconds = 0.0, waitMs = 0.0;
+    size_t peakPoints = 0;
+    for (int round = 0; round <= rounds; ++round) {
+        for (size_t f = 0; f < frames.size(); ++f) {
+            auto start = bench::Clock::now();
+            glClear(GL_COLOR_BUFFER_BIT);
+            // Copies are staggered along the turntable so they stream different amounts
+            for (int m = 0; m < meshCount; ++m) {
+                sources[m] = &frames[(f + m * frames.size() / meshCount) % frames.size()];
+                ranges[m] = pool.streamPoints(sources[m]->data(), sources[m]->size());
+                pool.drawPoints(ranges[m]);
+            }
+            pool.endFrame();
+            glFlush();
+            peakPoints = std::max(peakPoints, pool.framePoints());
+            if (round == 0) continue;
+            seconds += bench::secondsSince(start);
+            waitMs += pool.frameWaitMs();
+        }
+    }
+    glFinish();
+
+    bool ok = true;
+    glBindBuffer(GL_ARRAY_BUFFER, pool.stream().buffer());
+    for (int m = 0; m < meshCount; ++m) {
+        std::vector<WuVertex> readBack(ranges[m].count);
+        glGetBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(ranges[m].first * sizeof(WuVertex)),
+                           static_cast<GLsizeiptr>(readBack.size() * sizeof(WuVertex)), readBack.data());
+        ok = ok && readBack.size() == sources[m]->size() &&
+             std::memcmp(readBack.data(), sources[m]->data(), readBack.size() * sizeof(WuVertex)) == 0;
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glDisable(GL_BLEND);
+
+    const GpuBufferPool::MemoryStats memory = pool.memory();
+    const size_t frameCount = frames.size() * rounds;
+    const double fixedBytes = static_cast<double>(meshCount) * kFixedPointsPerMesh * sizeof(WuVertex) + memory.staticBytes;
+    std::printf("scene of %2d meshes (%s): %7.3f ms/frame, wait %6.3f ms, peak %.2f MB of points/frame | GPU memory "
+                "%7.2f MB (stream %.2f, static %.2f) vs. %8.2f MB with a fixed VBO per mesh  %s\n",
+                meshCount, pool.stream().modeName(), seconds * 1000.0 / frameCount, waitMs / frameCount,
+                peakPoints * sizeof(WuVertex) / 1e6, memory.totalBytes() / 1e6, memory.streamBytes / 1e6,
+                memory.staticBytes / 1e6, fixedBytes / 1e6, ok ? "ok" : "MISMATCH");
+    pool.destroy();
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 2;
+    int frameCount = 30;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    GLFWwindow* window = bench::createHiddenContext(kSize, kSize, "stream_buffer_bench");
+    if (!window) {
+        std::fprintf(stderr, "Could not create a GL 3.3 context (try LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a)\n");
+        return 1;
+    }
+    std::printf("GL %s, %s; persistent mapping %s\n", reinterpret_cast<const char*>(glGetString(GL_VERSION)),
+                reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+                streamBufferPersistentSupported() ? "available" : "not available");
+
+    // The points of every turntable step, computed once so only the upload is timed
+    Mesh mesh(input);
+    if (!bench::loadMesh(input, levels, mesh)) return 1;
+    std::vector<std::vector<WuVertex>> frames;
+    size_t totalPoints = 0;
+    for (const bench::Frame& f : bench::orbitFrames(mesh.points, frameCount, kSize, kSize)) {
+        mesh.buildLineVertices(f.model, f.view, f.projection, f.width, f.height, glm::vec4(1.0f, 0.5f, 0.5f, 1.0f), f.viewport);
+        frames.push_back(mesh.wu_vertex_buffer);
+        totalPoints += mesh.wu_vertex_buffer.size();
+    }
+    std::printf("%s subdivided %d times: %d frames, %.2f MB of points per frame\n", input.c_str(), levels, frameCount,
+                totalPoints * sizeof(WuVertex) / 1e6 / frameCount);
+
+    Shader shader("shaders/wu_line.vert", "shaders/wu_line.frag");
+    bool ok = true;
+    std::vector<unsigned char> reference;
+    const StreamBuffer::Mode modes[] = {StreamBuffer::Mode::SubData, StreamBuffer::Mode::Orphaning, StreamBuffer::Mode::Persistent};
+    for (StreamBuffer::Mode mode : modes) {
+        if (mode == StreamBuffer::Mode::Persistent && !streamBufferPersistentSupported()) continue;
+        const char* name = "";
+        const ModeResult r = runMode(mode, shader, frames, 3, name);
+        if (reference.empty()) reference = r.image;
+        const bool sameImage = r.image == reference;
+        const bool pass = r.readBackOk && sameImage;
+        ok = ok && pass;
+        std::printf("%-16s %7.3f ms/frame  wait %7.3f ms/frame  %8.1f MB/s  read-back %s, image %s\n", name, r.cpuMs,
+                    r.waitMs, r.megabytesPerSecond, r.readBackOk ? "ok" : "MISMATCH", sameImage ? "identical" : "DIFFERS");
+    }
+
+    for (int meshCount : {1, 4, 10}) ok = runScene(shader, mesh, frames, meshCount, 3) && ok;
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+    return ok ? 0 : 1;
+}
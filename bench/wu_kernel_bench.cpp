@@ -0,0 +1,141 @@
+// Wu line kernel throughput in pixels/s: the floating-point drawWuLine2D()
+// (returning a vector, and as rasterizeWuLine() into a sink) against the
+// 16.16 fixed-point drawWuLine2DFixed(), scalar and vectorized.
+// Lines are random segments on a 1920x1080 screen with lengths from mesh
+// edge scale up to --max-length. Every fixed-point line is compared with
+// the float one per pixel; coverage may differ by quantization and by the
+// rounding of the 16.16 step, but not by more than the reported bound.
+//
+// Usage: wu_kernel_bench [--lines N] [--max-length L] [--repeat N]
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "xiaolin_wu.hpp"
+
+namespace {
+
+struct Segment {
+    glm::vec2 p0, p1;
+};
+
+std::vector<Segment> randomSegments(size_t count, float maxLength) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> px(0.0f, 1919.0f), py(0.0f, 1079.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f), unit(0.0f, 1.0f);
+    std::vector<Segment> segments;
+    segments.reserve(count);
+    while (segments.size() < count) {
+        const glm::vec2 p0(px(rng), py(rng));
+        // Mostly short edges, as on a dense mesh, with a tail of long ones
+        const float length = 2.0f + (maxLength - 2.0f) * std::pow(unit(rng), 3.0f);
+        const float a = angle(rng);
+        const glm::vec2 p1(p0.x + length * std::cos(a), p0.y + length * std::sin(a));
+        if (p1.x < 0.0f || p1.y < 0.0f || p1.x > 1919.0f || p1.y > 1079.0f) continue;
+        segments.push_back({p0, p1});
+    }
+    return segments;
+}
+
+int64_t pixelKey(int x, int y) { return (int64_t(x) << 32) ^ uint32_t(y); }
+
+// Largest per-pixel intensity difference between the two kernels for one line
+double lineError(const Segment& s, WuColumns8& columns, std::vector<Pixel>& fixed,
+                 std::unordered_map<int64_t, double>& diff) {
+    diff.clear();
+    fixed.clear();
+    for (const Pixel& p : drawWuLine2D(s.p0, s.p1)) diff[pixelKey(p.x, p.y)] += p.intensity;
+    drawWuLine2DFixed(s.p0, s.p1, columns);
+    appendWuPixels(columns, fixed);
+    for (const Pixel& p : fixed) diff[pixelKey(p.x, p.y)] -= p.intensity;
+    double worst = 0.0;
+    for (const auto& entry : diff) worst = std::max(worst, std::abs(entry.second));
+    return worst;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t lineCount = 200000;
+    float maxLength = 400.0f;
+    int repeat = 5;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--lines") && i + 1 < argc) lineCount = std::strtoul(argv[++i], nullptr, 10);
+        else if (!std::strcmp(argv[i], "--max-length") && i + 1 < argc) maxLength = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = std::atoi(argv[++i]);
+    }
+
+    const std::vector<Segment> segments = randomSegments(lineCount, std::max(maxLength, 3.0f));
+    size_t pixelsPerPass = 0;
+    for (const Segment& s : segments) pixelsPerPass += drawWuLine2D(s.p0, s.p1).size();
+    std::printf("%zu lines up to %.0f px, %zu pixels per pass, %d passes\n", segments.size(), maxLength,
+                pixelsPerPass, repeat);
+
+    size_t sink = 0;
+    auto start = bench::Clock::now();
+    for (int r = 0; r < repeat; ++r) {
+        for (const Segment& s : segments) sink += drawWuLine2D(s.p0, s.p1).size();
+    }
+    const double reference = bench::secondsSince(start);
+    std::printf("%-20s %8.1f M pixels/s\n", "float", pixelsPerPass * repeat / reference * 1e-6);
+
+    // Same float kernel writing through a sink: no vector per line
+    std::vector<Pixel> span(pixelsPerPass);
+    start = bench::Clock::now();
+    for (int r = 0; r < repeat; ++r) {
+        Pixel* out = span.data();
+        for (const Segment& s : segments) {
+            rasterizeWuLine(s.p0, s.p1, [&](int x, int y, double intensity) { *out++ = {x, y, intensity}; });
+        }
+        sink += static_cast<size_t>(out - span.data());
+    }
+    const double sinkSeconds = bench::secondsSince(start);
+    std::printf("%-20s %8.1f M pixels/s  %6.1fx\n", "float sink", pixelsPerPass * repeat / sinkSeconds * 1e-6,
+                reference / sinkSeconds);
+
+    WuColumns8 columns;
+    for (bool vectorized : {false, true}) {
+        size_t pixels = 0;
+        start = bench::Clock::now();
+        for (int r = 0; r < repeat; ++r) {
+            for (const Segment& s : segments) {
+                drawWuLine2DFixed(s.p0, s.p1, columns, vectorized);
+                pixels += 2 * columns.size();
+                sink += columns.lower[columns.size() / 2];
+            }
+        }
+        const double seconds = bench::secondsSince(start);
+        std::printf("%-20s %8.1f M pixels/s  %6.1fx\n", vectorized ? "fixed 16.16 SIMD" : "fixed 16.16 scalar",
+                    pixels / seconds * 1e-6, reference / seconds);
+    }
+
+    // Vectorized and scalar must agree exactly; both against float within the bound
+    bool identical = true;
+    WuColumns8 scalar;
+    std::vector<Pixel> fixed;
+    std::unordered_map<int64_t, double> diff;
+    double worst = 0.0, total = 0.0;
+    const size_t checked = std::min<size_t>(segments.size(), 20000);
+    for (size_t i = 0; i < checked; ++i) {
+        const Segment& s = segments[i];
+        drawWuLine2DFixed(s.p0, s.p1, scalar, false);
+        drawWuLine2DFixed(s.p0, s.p1, columns, true);
+        identical = identical && scalar.minor == columns.minor && scalar.upper == columns.upper &&
+                    scalar.lower == columns.lower;
+        const double error = lineError(s, columns, fixed, diff);
+        worst = std::max(worst, error);
+        total += error;
+    }
+    const double bound = 8.0 / 255.0;
+    const bool ok = identical && worst <= bound;
+    std::printf("checked %zu lines: scalar/SIMD %s, max coverage error %.4f (%.1f/255, bound %.0f/255), mean %.4f  %s\n",
+                checked, identical ? "identical" : "DIFFER", worst, worst * 255.0, bound * 255.0, total / checked,
+                ok ? "ok" : "MISMATCH");
+    return ok && sink ? 0 : 1;
+}
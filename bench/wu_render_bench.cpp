@@ -0,0 +1,122 @@
+// CPU frame time of the Xiaolin Wu path on a turntable around the mesh,
+// drawing every face outline versus each unique edge once, then the
+// unique-edge path with 1, 2, 4, ... rasterization threads (checked to
+// produce exactly the serial Wu vertices). Times the projection,
+// clipping and rasterization stages separately; the GL upload and draw
+// are not included.
+//
+// Usage: wu_render_bench [file.obj] [--levels N] [--frames N] [--size WxH] [--threads N]
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bench_common.hpp"
+#include "mesh.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+struct PathStats {
+    double project = 0, clip = 0, rasterize = 0;
+    size_t segments = 0, wuVertices = 0;
+};
+
+bool sameVertices(const std::vector<WuVertex>& a, const std::vector<WuVertex>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].position != b[i].position || !(a[i].color == b[i].color)) return false;
+    }
+    return true;
+}
+
+PathStats runPath(Mesh& mesh, Mesh::WuEdgeSource source, const std::vector<bench::Frame>& frames) {
+    const glm::vec4 color(1.0f, 0.5f, 0.5f, 1.0f);
+    PathStats stats;
+    for (const bench::Frame& f : frames) {
+        auto start = bench::Clock::now();
+        const ProjectedVertices& screen = mesh.projectToScreenSpace(f.model, f.view, f.projection, f.width, f.height);
+        stats.project += bench::secondsSince(start);
+
+        start = bench::Clock::now();
+        Mesh::ClipResult segments = source == Mesh::UNIQUE_EDGES ? mesh.clipToViewport(screen, f.viewport)
+                                                                 : mesh.clipFacesToViewport(screen, f.viewport);
+        stats.clip += bench::secondsSince(start);
+
+        start = bench::Clock::now();
+        mesh.wu_vertex_buffer.clear();
+        mesh.rasterizeSegments(segments, color, wuLineRasterizer());
+        stats.rasterize += bench::secondsSince(start);
+
+        stats.segments += segments.visibleEdges.size() + segments.boundarySegments.size();
+        stats.wuVertices += mesh.wu_vertex_buffer.size();
+    }
+    return stats;
+}
+
+void printPath(const char* label, const PathStats& s, size_t frames) {
+    const double ms = 1000.0 / frames;
+    std::printf("%-14s %8.2f ms/frame (project %6.2f, clip %6.2f, rasterize %7.2f)  %9zu segments  %10zu Wu vertices\n",
+                label, (s.project + s.clip + s.rasterize) * ms, s.project * ms, s.clip * ms, s.rasterize * ms,
+                s.segments / frames, s.wuVertices / frames);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string input = "assets/bunny.obj";
+    int levels = 0;
+    int frameCount = 60;
+    int width = 1080, height = 1080;
+    unsigned maxThreads = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "--levels") && i + 1 < argc) levels = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--frames") && i + 1 < argc) frameCount = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--size") && i + 1 < argc) std::sscanf(argv[++i], "%dx%d", &width, &height);
+        else if (!std::strcmp(argv[i], "--threads") && i + 1 < argc) maxThreads = std::atoi(argv[++i]);
+        else input = argv[i];
+    }
+
+    Mesh mesh(input);
+    if (!bench::loadMesh(input, levels, mesh)) return 1;
+    std::printf("%s subdivided %d times: %zu vertices, %zu faces, %zu unique edges, %dx%d, %d frames\n",
+                input.c_str(), levels, mesh.points.size(), mesh.face_indices.size(), mesh.edge_indices.size(),
+                width, height, frameCount);
+
+    const std::vector<bench::Frame> frames = bench::orbitFrames(mesh.points, frameCount, width, height);
+    PathStats faces = runPath(mesh, Mesh::FACE_POLYGONS, frames);
+    PathStats edges = runPath(mesh, Mesh::UNIQUE_EDGES, frames);
+    printPath("face polygons", faces, frames.size());
+    printPath("unique edges", edges, frames.size());
+    const double total = faces.project + faces.clip + faces.rasterize;
+    std::printf("speedup: %.2fx frame, %.2fx rasterization\n", total / (edges.project + edges.clip + edges.rasterize),
+                faces.rasterize / edges.rasterize);
+
+    // Thread sweep on the unique-edge path, compared with the serial output of a middle frame
+    const bench::Frame& probe = frames[frames.size() / 2];
+    const glm::vec4 color(1.0f, 0.5f, 0.5f, 1.0f);
+    mesh.rasterPool = nullptr;
+    mesh.buildLineVertices(probe.model, probe.view, probe.projection, probe.width, probe.height, color, probe.viewport);
+    const std::vector<WuVertex> serial = mesh.wu_vertex_buffer;
+
+    maxThreads = ThreadPool::resolveThreadCount(maxThreads);
+    bool identical = true;
+    for (unsigned threads = 1; ; threads = std::min(threads * 2, maxThreads)) {
+        ThreadPool pool(threads);
+        mesh.rasterPool = &pool;
+        PathStats stats = runPath(mesh, Mesh::UNIQUE_EDGES, frames);
+        mesh.buildLineVertices(probe.model, probe.view, probe.projection, probe.width, probe.height, color, probe.viewport);
+        const bool same = sameVertices(serial, mesh.wu_vertex_buffer);
+        identical = identical && same;
+        char label[32];
+        std::snprintf(label, sizeof(label), "%u raster thr.", threads);
+        printPath(label, stats, frames.size());
+        std::printf("%14s %.2fx rasterization vs. serial, output %s\n", "", edges.rasterize / stats.rasterize,
+                    same ? "identical" : "MISMATCH");
+        if (threads == maxThreads) break;
+    }
+    mesh.rasterPool = nullptr;
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file framebuffer_quad.hpp
+ * @brief Uploads a TileFramebuffer to a texture and draws it over the window.
+ */
+#pragma once
+#include "shader.hpp"
+#include "tile_framebuffer.hpp"
+
+/**
+ * @brief One RGBA8 texture plus the state needed to draw it as a fullscreen quad.
+ *
+ * Requires a current GL context for every call. The quad is generated in
+ * the vertex shader from gl_VertexID, so no vertex buffer is used.
+ */
+class FramebufferQuad {
+public:
+    /**
+     * @brief Creates the texture and vertex array.
+     */
+    void init();
+
+    /**
+     * @brief Copies the framebuffer into the texture (one glTexSubImage2D per frame).
+     * @return Bytes uploaded.
+     */
+    size_t upload(const TileFramebuffer& framebuffer);
+
+    /**
+     * @brief Composites the texture over the current window contents.
+     * @param shader Program built from shaders/framebuffer.vert and shaders/framebuffer.frag.
+     */
+    void draw(Shader* shader);
+
+    /**
+     * @brief Deletes the GL objects.
+     */
+    void destroy();
+
+private:
+    unsigned int texture = 0;
+    unsigned int VAO = 0;
+    int textureWidth = 0, textureHeight = 0;
+};
@@ -0,0 +1,109 @@
+/**
+ * @file gpu_buffer_pool.hpp
+ * @brief Scene-wide owner of the GPU buffers the meshes draw from.
+ */
+#pragma once
+#include <cstddef>
+#include <unordered_map>
+
+#include "line_rasterizer.hpp"
+#include "stream_buffer.hpp"
+
+/**
+ * @brief One streaming buffer shared by all meshes plus exactly sized static buffers.
+ *
+ * Every frame, each mesh in a CPU rasterized mode appends its Wu points to
+ * the shared StreamBuffer and draws its own sub-range of it, so the scene
+ * holds a single ring sized from the points actually drawn per frame
+ * instead of a fixed reservation per mesh. Regions grow to 1.5x the frame's
+ * demand and shrink again once the peak over the last kShrinkFrames frames
+ * needs less than a quarter of them.
+ *
+ * Static buffers (positions and edge indices for the hardware modes) are
+ * created through the pool with exactly their data's size, so memory() can
+ * report everything the meshes hold on the GPU. Requires a current GL
+ * context for every call except memory().
+ */
+class GpuBufferPool {
+public:
+    static constexpr int kShrinkFrames = 300;
+
+    /**
+     * @brief Elements of the shared stream written by one mesh in one frame.
+     */
+    struct Range {
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    /**
+     * @brief GPU memory held by the pool in bytes.
+     */
+    struct MemoryStats {
+        size_t streamBytes = 0;   ///< All regions of the shared stream
+        size_t staticBytes = 0;   ///< Static buffers created with createStatic()
+        size_t staticBuffers = 0;
+        size_t totalBytes() const { return streamBytes + staticBytes; }
+    };
+
+    /**
+     * @brief Creates the shared stream and its vertex array; true on success.
+     * @param initialPoints Initial capacity of each region in points, grown on demand.
+     * @param mode Upload strategy of the stream.
+     */
+    bool init(size_t initialPoints = 1 << 14, StreamBuffer::Mode mode = StreamBuffer::Mode::Auto);
+
+    /**
+     * @brief Deletes the stream, its vertex array and every static buffer still alive.
+     */
+    void destroy();
+
+    /**
+     * @brief Creates a buffer holding exactly bytes of data, bound to target in the current VAO.
+     * @param target GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER.
+     * @return The buffer name, or 0 on failure.
+     */
+    unsigned int createStatic(unsigned int target, const void* data, size_t bytes);
+
+    /**
+     * @brief Deletes a buffer made by createStatic() and sets it to 0.
+     */
+    void releaseStatic(unsigned int& buffer);
+
+    /**
+     * @brief Appends count points to this frame's region of the shared stream.
+     */
+    Range streamPoints(const WuVertex* data, size_t count);
+
+    /**
+     * @brief Draws a range returned by streamPoints() this frame as GL_POINTS with the bound program.
+     */
+    void drawPoints(const Range& range);
+
+    /**
+     * @brief Ends the frame after the last drawPoints(); fences the region and right-sizes the stream.
+     */
+    void endFrame();
+
+    MemoryStats memory() const;
+    const StreamBuffer& stream() const { return pointStream; }
+    /// Points streamed by all meshes in the last frame
+    size_t framePoints() const { return lastFramePoints; }
+    /// Time the last frame's uploads spent waiting, in milliseconds
+    double frameWaitMs() const { return lastFrameWaitMs; }
+
+private:
+    void bindPointAttributes();
+
+    StreamBuffer pointStream;
+    unsigned int pointVAO = 0;
+    unsigned int pointVAOBuffer = 0; // Buffer pointVAO's attributes point at
+    std::unordered_map<unsigned int, size_t> staticSizes;
+    size_t staticBytes = 0;
+
+    size_t framePointCount = 0, lastFramePoints = 0;
+    double frameWait = 0.0, lastFrameWaitMs = 0.0;
+    // Largest frame in the current shrink window
+    size_t peakPoints = 0;
+    int framesSincePeakReset = 0;
+};
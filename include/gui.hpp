@@ -43,5 +43,8 @@ void shutdownImGui();
  * @param state Reference to the GUI state struct.
  * @param mesh Reference to the mesh object.
  * @param transformState Pointer to the current transformation state struct.
+ * @param viewportRect Clip rectangle edited by the viewport sliders.
+ * @param renderSettings Rendering knobs edited by the GUI (raster threads).
+ * @param gpuPool Scene buffer pool, for the upload and GPU memory statistics.
  */
-void renderGui(GuiState& state, Mesh& mesh, TransformState* transformState, ViewportRect& viewportRect);
+void renderGui(GuiState& state, Mesh& mesh, TransformState* transformState, ViewportRect& viewportRect, RenderSettings& renderSettings, const GpuBufferPool& gpuPool);
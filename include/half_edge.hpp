@@ -1,94 +1,319 @@
-
 /**
  * @file half_edge.hpp
  * @brief HalfEdge implementation.
  */
 
 #pragma once
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
-#include <set>
 #include "utils.hpp"
 
-// Forward declarations to resolve circular dependencies
-struct HalfEdge;
-struct Vertex;
-struct Face;
+class ThreadPool;
 
 /**
- * @brief Vertex in a half-edge mesh structure.
- *
- * Stores 3D position and a pointer to one outgoing half-edge.
+ * @brief Index of a vertex, half-edge or face in a HalfEdgeMesh.
  */
-struct Vertex {
-    float x, y, z;           ///< 3D position
-    HalfEdge* edge = nullptr;///< Pointer to one outgoing half-edge
-};
+using HEIndex = uint32_t;
+
+/**
+ * @brief Marks a missing link (boundary twin, isolated vertex).
+ */
+constexpr HEIndex HE_INVALID = 0xFFFFFFFFu;
 
 /**
- * @brief Half-edge in a half-edge mesh structure.
+ * @brief Half-edge mesh connectivity stored as structure-of-arrays.
  *
- * Stores pointers to origin vertex, twin edge, next edge, and face.
+ * Elements refer to each other by 32-bit index, so the structure is
+ * relocatable: it can be copied, moved, memcpy'd to disk or shared
+ * between threads without fixing up pointers. Vertex positions are kept
+ * by the owner (see Mesh::points) and are indexed by the same vertex index.
  */
-struct HalfEdge {
-    Vertex* origin = nullptr;///< Origin vertex
-    HalfEdge* twin = nullptr;///< Twin (opposite) half-edge
-    HalfEdge* next = nullptr;///< Next half-edge in face
-    Face* face = nullptr;    ///< Face this half-edge borders
+struct HalfEdgeMesh {
+    // Per half-edge
+    std::vector<HEIndex> origin; ///< Origin vertex
+    std::vector<HEIndex> twin;   ///< Twin (opposite) half-edge, HE_INVALID on a boundary
+    std::vector<HEIndex> next;   ///< Next half-edge in the face
+    std::vector<HEIndex> face;   ///< Face this half-edge borders
+
+    std::vector<HEIndex> vertexEdge; ///< Per vertex: one outgoing half-edge, HE_INVALID if isolated
+    std::vector<HEIndex> faceEdge;   ///< Per face: one bounding half-edge
+
+    size_t vertexCount() const { return vertexEdge.size(); }
+    size_t halfEdgeCount() const { return origin.size(); }
+    size_t faceCount() const { return faceEdge.size(); }
+
+    /**
+     * @brief Destination vertex of half-edge h.
+     */
+    HEIndex dest(HEIndex h) const { return origin[next[h]]; }
+
+    void clear() {
+        origin.clear();
+        twin.clear();
+        next.clear();
+        face.clear();
+        vertexEdge.clear();
+        faceEdge.clear();
+    }
 };
 
 /**
- * @brief Face in a half-edge mesh structure.
- *
- * Stores a pointer to one of its bounding half-edges.
+ * @brief Problems found while building a half-edge mesh.
  */
-struct Face {
-    HalfEdge* edge = nullptr;///< Pointer to one bounding half-edge
+struct HalfEdgeBuildReport {
+    static constexpr size_t kMaxSamples = 8;
+
+    size_t nonManifoldEdges = 0; ///< Undirected edges shared by more than two half-edges
+    std::vector<std::pair<HEIndex, HEIndex>> nonManifoldSamples; ///< Vertex pairs of the first few such edges
 };
 
 /**
  * @brief Get all faces adjacent to a given face.
- * @param f Pointer to the face.
- * @return Vector of adjacent face pointers.
+ * @param mesh Half-edge mesh.
+ * @param f Face index.
+ * @return Vector of adjacent face indices.
  */
-std::vector<Face*> getAdjacentFacesOfFace(Face* f);
+std::vector<HEIndex> getAdjacentFacesOfFace(const HalfEdgeMesh& mesh, HEIndex f);
 
 /**
  * @brief Get all faces adjacent to a given half-edge.
- * @param e Pointer to the half-edge.
- * @return Vector of adjacent face pointers.
+ * @param mesh Half-edge mesh.
+ * @param e Half-edge index.
+ * @return Vector of adjacent face indices.
  */
-std::vector<Face*> getAdjacentFacesOfEdge(HalfEdge* e);
+std::vector<HEIndex> getAdjacentFacesOfEdge(const HalfEdgeMesh& mesh, HEIndex e);
 
 /**
  * @brief Get all faces sharing a given vertex.
- * @param v Pointer to the vertex.
- * @return Vector of face pointers.
+ * @param mesh Half-edge mesh.
+ * @param v Vertex index.
+ * @return Vector of face indices.
+ */
+std::vector<HEIndex> getFacesOfVertex(const HalfEdgeMesh& mesh, HEIndex v);
+
+/**
+ * @brief Get all half-edges incident to a given vertex (outgoing and incoming).
+ * @param mesh Half-edge mesh.
+ * @param v Vertex index.
+ * @return Sorted vector of half-edge indices.
+ */
+std::vector<HEIndex> getEdgesOfVertex(const HalfEdgeMesh& mesh, HEIndex v);
+
+/**
+ * @brief Caller-provided output versions of the queries above.
+ *
+ * Each writes at most capacity indices to out and returns the number of
+ * results. If that number is larger than capacity the contents of out
+ * are unspecified; call again with at least that much room. Nothing is
+ * allocated.
+ */
+size_t getAdjacentFacesOfFace(const HalfEdgeMesh& mesh, HEIndex f, HEIndex* out, size_t capacity);
+size_t getAdjacentFacesOfEdge(const HalfEdgeMesh& mesh, HEIndex e, HEIndex* out, size_t capacity);
+size_t getFacesOfVertex(const HalfEdgeMesh& mesh, HEIndex v, HEIndex* out, size_t capacity);
+/// Sorted like the vector version when it fits; on overflow the return value is an upper bound.
+size_t getEdgesOfVertex(const HalfEdgeMesh& mesh, HEIndex v, HEIndex* out, size_t capacity);
+
+/**
+ * @brief Fixed-capacity result buffer for the adjacency queries, kept on the stack.
+ *
+ * count holds the full result size reported by the query; when it is
+ * larger than N only the buffer contents are unusable (see overflowed()).
+ */
+template <size_t N>
+struct FixedIndexBuffer {
+    HEIndex items[N];
+    size_t count = 0;
+
+    static constexpr size_t capacity() { return N; }
+    bool overflowed() const { return count > N; }
+    size_t size() const { return count < N ? count : N; }
+    bool empty() const { return count == 0; }
+    const HEIndex* begin() const { return items; }
+    const HEIndex* end() const { return items + size(); }
+    HEIndex operator[](size_t i) const { return items[i]; }
+};
+
+/// @return false if the result did not fit in N entries.
+template <size_t N>
+bool getAdjacentFacesOfFace(const HalfEdgeMesh& mesh, HEIndex f, FixedIndexBuffer<N>& out) {
+    out.count = getAdjacentFacesOfFace(mesh, f, out.items, N);
+    return !out.overflowed();
+}
+
+/// @return false if the result did not fit in N entries.
+template <size_t N>
+bool getAdjacentFacesOfEdge(const HalfEdgeMesh& mesh, HEIndex e, FixedIndexBuffer<N>& out) {
+    out.count = getAdjacentFacesOfEdge(mesh, e, out.items, N);
+    return !out.overflowed();
+}
+
+/// @return false if the result did not fit in N entries.
+template <size_t N>
+bool getFacesOfVertex(const HalfEdgeMesh& mesh, HEIndex v, FixedIndexBuffer<N>& out) {
+    out.count = getFacesOfVertex(mesh, v, out.items, N);
+    return !out.overflowed();
+}
+
+/// @return false if the result did not fit in N entries.
+template <size_t N>
+bool getEdgesOfVertex(const HalfEdgeMesh& mesh, HEIndex v, FixedIndexBuffer<N>& out) {
+    out.count = getEdgesOfVertex(mesh, v, out.items, N);
+    return !out.overflowed();
+}
+
+/**
+ * @brief Longest face loop the backward vertex walk will search for a predecessor.
+ */
+constexpr size_t kMaxFaceWalk = 256;
+
+/**
+ * @brief Previous half-edge in h's face, HE_INVALID if not found within kMaxFaceWalk steps.
+ */
+inline HEIndex prevHalfEdge(const HalfEdgeMesh& mesh, HEIndex h) {
+    HEIndex pred = h;
+    for (size_t i = 0; i < kMaxFaceWalk; ++i) {
+        if (mesh.next[pred] == h) return pred;
+        pred = mesh.next[pred];
+    }
+    return HE_INVALID;
+}
+
+/**
+ * @brief Calls fn(face) for each face adjacent to face f; lazy getAdjacentFacesOfFace().
+ */
+template <class F>
+void forEachAdjacentFaceOfFace(const HalfEdgeMesh& mesh, HEIndex f, F&& fn) {
+    if (f >= mesh.faceCount()) return;
+    const HEIndex start = mesh.faceEdge[f];
+    HEIndex e = start;
+    do {
+        // If the twin exists and is not the same face, it is a neighbour
+        const HEIndex t = mesh.twin[e];
+        if (t != HE_INVALID && mesh.face[t] != f) fn(mesh.face[t]);
+        e = mesh.next[e];
+    } while (e != start);
+}
+
+/**
+ * @brief Calls fn(face) for the one or two faces bordering half-edge e; lazy getAdjacentFacesOfEdge().
+ */
+template <class F>
+void forEachFaceOfEdge(const HalfEdgeMesh& mesh, HEIndex e, F&& fn) {
+    if (e >= mesh.halfEdgeCount()) return;
+    fn(mesh.face[e]);
+    const HEIndex t = mesh.twin[e];
+    if (t != HE_INVALID && mesh.face[t] != mesh.face[e]) fn(mesh.face[t]);
+}
+
+/**
+ * @brief Calls fn(he) for the half-edge leaving v in each face around v.
+ *
+ * Walks forward (twin->next) from vertexEdge[v]; if that hits a boundary,
+ * continues backward from the start edge's predecessor. The faces of the
+ * visited half-edges are exactly getFacesOfVertex(), in the same order.
  */
-std::vector<Face*> getFacesOfVertex(Vertex* v);
+template <class F>
+void forEachOutgoingHalfEdge(const HalfEdgeMesh& mesh, HEIndex v, F&& fn) {
+    if (v >= mesh.vertexCount() || mesh.vertexEdge[v] == HE_INVALID) return;
+    const HEIndex start = mesh.vertexEdge[v];
+
+    HEIndex current = start;
+    do {
+        fn(current);
+        current = mesh.twin[current] != HE_INVALID ? mesh.next[mesh.twin[current]] : HE_INVALID;
+    } while (current != HE_INVALID && current != start);
+
+    if (current != HE_INVALID) return;
+    // Hit a boundary: go the other way via the twin of each predecessor
+    HEIndex pred = prevHalfEdge(mesh, start);
+    if (pred == HE_INVALID) return; // Broken face loop
+    current = mesh.twin[pred];
+    while (current != HE_INVALID) {
+        fn(current);
+        pred = prevHalfEdge(mesh, current);
+        if (pred == HE_INVALID) break;
+        current = mesh.twin[pred];
+    }
+}
+
+/**
+ * @brief Calls fn(face) for each face around v; lazy getFacesOfVertex().
+ */
+template <class F>
+void forEachFaceOfVertex(const HalfEdgeMesh& mesh, HEIndex v, F&& fn) {
+    forEachOutgoingHalfEdge(mesh, v, [&](HEIndex he) { fn(mesh.face[he]); });
+}
 
 /**
- * @brief Get all half-edges originating from a given vertex.
- * @param v Pointer to the vertex.
- * @return Vector of half-edge pointers.
+ * @brief Calls fn(he) for each half-edge of v's faces that starts or ends at v.
+ *
+ * Same set as getEdgesOfVertex() but in walk order and unsorted. A face
+ * that appears twice around v (only on malformed meshes) repeats its edges.
+ */
+template <class F>
+void forEachEdgeOfVertex(const HalfEdgeMesh& mesh, HEIndex v, F&& fn) {
+    forEachFaceOfVertex(mesh, v, [&](HEIndex f) {
+        const HEIndex start = mesh.faceEdge[f];
+        HEIndex he = start;
+        do {
+            if (mesh.origin[he] == v || mesh.dest(he) == v) fn(he);
+            he = mesh.next[he];
+        } while (he != start);
+    });
+}
+
+/**
+ * @brief Next boundary half-edge along the same hole as boundary half-edge h.
+ *
+ * Rotates around dest(h) until an outgoing half-edge without a twin is
+ * found. Following this from any boundary half-edge traces its boundary
+ * loop. Returns HE_INVALID if h is not a boundary or the rotation does
+ * not terminate.
+ */
+inline HEIndex nextBoundaryHalfEdge(const HalfEdgeMesh& mesh, HEIndex h) {
+    if (mesh.twin[h] != HE_INVALID) return HE_INVALID;
+    HEIndex candidate = mesh.next[h];
+    for (size_t steps = mesh.halfEdgeCount(); steps > 0; --steps) {
+        const HEIndex t = mesh.twin[candidate];
+        if (t == HE_INVALID) return candidate;
+        candidate = mesh.next[t];
+    }
+    return HE_INVALID;
+}
+
+/**
+ * @brief Sets the twin link of every half-edge from origin/next.
+ *
+ * Half-edges are sorted on a packed undirected edge key (radix sort, no
+ * hashing). For each directed edge the highest-numbered half-edge is
+ * linked to the highest-numbered half-edge of the opposite direction;
+ * edges used by more than two half-edges are reported as non-manifold.
+ *
+ * @param mesh Connectivity with origin, next and vertexEdge sized; twin is overwritten.
+ * @param pool Optional thread pool for the sort and the linking.
+ * @return Non-manifold edges found.
  */
-std::vector<HalfEdge*> getEdgesOfVertex(Vertex* v);
+HalfEdgeBuildReport linkTwinHalfEdges(HalfEdgeMesh& mesh, ThreadPool* pool = nullptr);
 
 /**
  * @brief Build a half-edge mesh from points and face indices.
  *
- * Populates the vertices, halfedges, and faces vectors.
+ * Half-edges are numbered in face order, so the half-edges of face f are
+ * face_list.offsets[f] .. face_list.offsets[f+1]-1. With a thread pool the
+ * faces are filled, twins matched and vertex half-edges chosen in
+ * parallel; the result is bit-identical to the serial build.
  *
  * @param points List of vertex positions.
- * @param face_indices List of faces (each as a list of vertex indices).
- * @param vertices Output vector of Vertex structs.
- * @param halfedges Output vector of HalfEdge structs.
- * @param faces Output vector of Face structs.
+ * @param face_list Faces in CSR layout (vertex indices per face).
+ * @param mesh Output connectivity.
+ * @param pool Optional thread pool.
+ * @return Non-manifold edges found.
  */
-void buildHalfEdgeMeshFromPointsAndFaces(
+HalfEdgeBuildReport buildHalfEdgeMeshFromPointsAndFaces(
     const std::vector<Point>& points,
-    const std::vector<std::vector<int>>& face_indices,
-    std::vector<Vertex>& vertices,
-    std::vector<HalfEdge>& halfedges,
-    std::vector<Face>& faces
-);
\ No newline at end of file
+    const FaceList& face_list,
+    HalfEdgeMesh& mesh,
+    ThreadPool* pool = nullptr
+);
@@ -0,0 +1,50 @@
+/**
+ * @file headless.hpp
+ * @brief Rendering without a display: a fixed camera path through the CPU tile framebuffer.
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mesh.hpp"
+#include "tile_framebuffer.hpp"
+
+/**
+ * @brief What runHeadless() renders and where the frames go.
+ */
+struct HeadlessOptions {
+    int width = 1080;            ///< Image size in pixels
+    int height = 1080;
+    int frames = 60;             ///< Steps of the camera path, one full turn about y
+    std::string outputDir;       ///< Directory for frame_NNNN.ppm; empty writes no images
+    int saveEvery = 1;           ///< Write every Nth frame (the first frame is always written)
+    unsigned rasterThreads = 1;  ///< Tile rasterization threads (0 = all hardware threads)
+    Mesh::WuEdgeSource edgeSource = Mesh::UNIQUE_EDGES;
+};
+
+/**
+ * @brief Loads the OBJ files and renders them along the camera path without any GL or window.
+ *
+ * The scene turns once about the vertical axis through the centre of the
+ * bounding box of all meshes, seen through the viewer's field of view (with
+ * near and far planes just around the scene, so any mesh scale fits) from far
+ * enough back to stay inside the viewport margin (100 px, or a tenth of the
+ * shorter side for images under 1000 px). Every mesh is Wu-rasterized into
+ * a TileFramebuffer (Mesh::drawToFramebuffer), composited over the viewer's
+ * background and optionally written as a binary PPM. Prints the time per
+ * frame, a summary and a 64-bit FNV-1a checksum over all frames, which only
+ * changes when the rendered output does.
+ *
+ * @return true if every mesh loaded and every requested image was written.
+ */
+bool runHeadless(const std::vector<std::string>& filenames, const MeshLoadOptions& loadOptions, const HeadlessOptions& options);
+
+/**
+ * @brief Writes the premultiplied framebuffer composited over an opaque background as a binary PPM (P6).
+ */
+bool writePPM(const std::string& path, const TileFramebuffer& framebuffer, const glm::vec3& background);
+
+/**
+ * @brief 64-bit FNV-1a hash of the framebuffer's pixels, continuing from seed.
+ */
+uint64_t framebufferChecksum(const TileFramebuffer& framebuffer, uint64_t seed = 14695981039346656037ull);
@@ -0,0 +1,60 @@
+/**
+ * @file line_rasterizer.hpp
+ * @brief CPU line rasterization algorithms behind one interface.
+ */
+#pragma once
+#include <cstddef>
+#include <glm/glm.hpp>
+
+struct WuVertex {
+    glm::vec2 position; // 2D screen position
+    glm::vec4 color;    // Color with intensity in alpha
+};
+
+/**
+ * @brief Turns screen-space segments into colored pixels.
+ *
+ * Implementations are stateless and shared, so one instance may be used
+ * from several threads at once. Callers size the output with pixelBound()
+ * and let rasterize() write straight into it.
+ */
+class LineRasterizer {
+public:
+    virtual ~LineRasterizer() = default;
+
+    /**
+     * @brief Short display name ("Wu", "Bresenham", ...).
+     */
+    virtual const char* name() const = 0;
+
+    /**
+     * @brief Most pixels rasterize() can write for the segment p0-p1.
+     */
+    virtual size_t pixelBound(glm::vec2 p0, glm::vec2 p1) const = 0;
+
+    /**
+     * @brief Rasterizes one segment.
+     *
+     * @param p0 The starting 2D point (in screen coordinates).
+     * @param p1 The ending 2D point (in screen coordinates).
+     * @param rgb Line color; alpha is the pixel's coverage (1 for aliased algorithms).
+     * @param out Room for at least pixelBound(p0, p1) vertices.
+     * @return One past the last vertex written.
+     */
+    virtual WuVertex* rasterize(glm::vec2 p0, glm::vec2 p1, const glm::vec3& rgb, WuVertex* out) const = 0;
+};
+
+/**
+ * @brief Xiaolin Wu's anti-aliased lines; pixels with coverage at most 0.05 are dropped.
+ */
+const LineRasterizer& wuLineRasterizer();
+
+/**
+ * @brief Integer Bresenham lines between the rounded endpoints, one opaque pixel per major-axis step.
+ */
+const LineRasterizer& bresenhamLineRasterizer();
+
+/**
+ * @brief DDA lines: the float endpoints stepped by at most one pixel per axis, rounded to pixels.
+ */
+const LineRasterizer& ddaLineRasterizer();
@@ -0,0 +1,90 @@
+/**
+ * @file log.hpp
+ * @brief Low-overhead leveled logging drained by a background thread.
+ *
+ * LOG_DEBUG(...) and friends take printf-style arguments. Messages below
+ * CG_LOG_MIN_LEVEL are removed at compile time (arguments are not even
+ * evaluated); the rest are checked against the runtime level, formatted
+ * into a slot of a lock-free ring buffer and written to stderr by a
+ * background thread, so the calling thread never blocks on I/O. When the
+ * ring is full, messages are dropped and counted instead of waiting.
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Severity of a log message, lowest first.
+ */
+enum class LogLevel : uint8_t {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warn = 3,
+    Error = 4,
+    Off = 5
+};
+
+// Messages below this level are compiled out. Set from CMake (CG_LOG_MIN_LEVEL).
+#ifndef CG_LOG_MIN_LEVEL
+#define CG_LOG_MIN_LEVEL 1
+#endif
+
+/**
+ * @brief Sets the runtime level; messages below it are discarded. Default Info.
+ */
+void setLogLevel(LogLevel level);
+
+/**
+ * @brief Current runtime level.
+ */
+LogLevel logLevel();
+
+// Runtime level; read inline by logEnabled() so disabled messages cost one load
+extern std::atomic<uint8_t> g_logLevel;
+
+/**
+ * @brief True if a message of this level would be recorded.
+ */
+inline bool logEnabled(LogLevel level) {
+    return level != LogLevel::Off && static_cast<uint8_t>(level) >= g_logLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Parses "trace", "debug", "info", "warn", "error" or "off".
+ * @return false if the name is unknown.
+ */
+bool parseLogLevel(const std::string& name, LogLevel& level);
+
+/**
+ * @brief Formats a message into the ring buffer. Use the LOG_* macros instead.
+ */
+void logWrite(LogLevel level, const char* format, ...)
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+/**
+ * @brief Blocks until every message recorded so far has been written.
+ */
+void logFlush();
+
+/**
+ * @brief Messages dropped because the ring buffer was full.
+ */
+size_t logDroppedCount();
+
+#define CG_LOG_AT(level, ...)                                                         \
+    do {                                                                              \
+        if (static_cast<int>(level) >= CG_LOG_MIN_LEVEL && logEnabled(level))         \
+            logWrite(level, __VA_ARGS__);                                             \
+    } while (0)
+
+#define LOG_TRACE(...) CG_LOG_AT(LogLevel::Trace, __VA_ARGS__)
+#define LOG_DEBUG(...) CG_LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...) CG_LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARN(...) CG_LOG_AT(LogLevel::Warn, __VA_ARGS__)
+#define LOG_ERROR(...) CG_LOG_AT(LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,50 @@
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only memory mapping of whole files.
+ */
+#pragma once
+#include <string>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Maps a file read-only into memory for the lifetime of the object.
+ *
+ * On POSIX systems the file is mapped with mmap, elsewhere it is read into
+ * a private buffer. The object is move-only.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Maps the given file, replacing any previous mapping.
+     * @param filename Path to the file.
+     * @return True on success (an empty file maps to size() == 0).
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Releases the mapping.
+     */
+    void close();
+
+    const char* data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+    const char* begin() const { return mappedData; }
+    const char* end() const { return mappedData + mappedSize; }
+    bool isOpen() const { return opened; }
+
+private:
+    const char* mappedData = nullptr;
+    size_t mappedSize = 0;
+    bool opened = false;
+    bool isMapped = false;          ///< True if mappedData came from mmap
+    std::vector<char> fallbackBuffer; ///< Used when mmap is unavailable
+};
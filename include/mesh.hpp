@@ -8,6 +8,12 @@
 #include <string>
 #include "utils.hpp"
 #include "half_edge.hpp"
+#include "line_rasterizer.hpp"
+#include "one_ring.hpp"
+#include "projection.hpp"
+#include "segment_clip.hpp"
+#include "gpu_buffer_pool.hpp"
+#include "tile_framebuffer.hpp"
 #include "weiler-atherton-clip.hpp"
 #include <glm/glm.hpp>
 #include "shader.hpp"
@@ -19,16 +25,31 @@ struct ViewportRect {
     int x_min, y_min, x_max, y_max;
 };
 
-struct WuVertex {
-    glm::vec2 position; // 2D screen position
-    glm::vec4 color;    // Color with intensity in alpha
+// How Mesh::load obtains the mesh
+struct MeshLoadOptions {
+    unsigned threads = 1;       // Parser and half-edge build threads (1 = serial, 0 = all hardware threads)
+    bool useCache = true;       // Read/write the binary cache next to the OBJ file
+    bool rebuildCache = false;  // Ignore an existing cache and write a fresh one
 };
 
+// Rendering knobs shared by every mesh (the viewer keeps one in globals.hpp)
+struct RenderSettings {
+    // Where Wu lines are accumulated
+    enum WuBackend {
+        WU_POINTS,     // One GL point per covered pixel (Mesh::drawRasterizedLines)
+        WU_FRAMEBUFFER // CPU tile framebuffer, uploaded as a single texture per frame (Mesh::drawToFramebuffer)
+    };
+
+    unsigned rasterThreads = 1; // CPU rasterization threads (1 = render thread only, 0 = all hardware threads)
+    WuBackend wuBackend = WU_POINTS; // XIAOLIN_WU meshes only; BRESENHAM and DDA always use GL points
+};
+
+class ThreadPool;
+
 class Mesh {
     private:
         glm::mat4 modelMatrix = glm::mat4(1.0f); // Identity matrix
         Shader *shader;
-        size_t wu_vbo_allocated_size = 0;
 
     public:
         glm::mat4 objectTransform = glm::mat4(1.0f);
@@ -36,34 +57,82 @@ class Mesh {
 
         // Enum to define the available rendering modes
         enum RenderMode {
-            LINES,
-            POINTS,
-            XIAOLIN_WU,
-            BRESENHAM
+            LINES,      // Hardware GL_LINES over the edge list (drawWithGL)
+            POINTS,     // Hardware GL_POINTS at the mesh vertices (drawWithGL)
+            XIAOLIN_WU, // CPU rasterizers: project, clip and rasterize edges (drawRasterizedLines)
+            BRESENHAM,
+            DDA,
+            GPU_WU      // Antialiased lines expanded and shaded on the GPU from the static buffers (drawGpuLines)
         };
 
         // Raw data loaded from the OBJ file
         std::vector<Point> points;
-        std::vector<std::vector<int>> face_indices;
+        FaceList face_indices;
+
+        // Half-edge connectivity (index-based, vertex i is points[i])
+        HalfEdgeMesh halfEdgeMesh;
+        // One-ring tables, built on first use by vertexOneRing()
+        VertexOneRing oneRing;
 
-        // Half-edge data structures
-        std::vector<Vertex> verticesHE;
-        std::vector<HalfEdge> halfedgesHE;
-        std::vector<Face> facesHE;
+        // Copy of points for the projection kernels; refreshed when the vertex count
+        // changes, call positionsSoA.assign(points) after editing points in place
+        SoAPositions positionsSoA;
+        // Screen positions of the last projectToScreenSpace() call, reused every frame
+        ProjectedVertices projected;
+        // Output of the last clipFacesToViewport() call, reused every frame
+        WA_ClippedPolygons clippedFaces;
+        // Screen-space edges of the last clipToViewport() call, clipped in place
+        SegmentBatch edgeSegments;
 
-        // For XIOLIN_WU rendering
-        unsigned int VAO_wu, VBO_wu;
+        // For the CPU rasterized modes (XIAOLIN_WU, BRESENHAM, DDA)
+        // Scene buffer pool the GPU buffers come from, not owned; set by setupMesh()
+        GpuBufferPool* gpuPool = nullptr;
+        // This frame's sub-range of the pool's shared stream holding wu_vertex_buffer
+        GpuBufferPool::Range wuRange;
         std::vector<std::pair<unsigned int, unsigned int>> edge_indices;
         std::vector<WuVertex> wu_vertex_buffer;
+        // Per-chunk output of the parallel rasterizer, concatenated into wu_vertex_buffer
+        std::vector<std::vector<WuVertex>> wu_chunk_buffers;
+        // Shared worker pool for rasterization, not owned; nullptr rasterizes on the calling thread
+        ThreadPool* rasterPool = nullptr;
         unsigned int wu_point_count = 0;
+        // For LINES and POINTS: positions and edge_indices on the GPU, drawn with the MVP in the shader
+        unsigned int VAO_gl = 0, VBO_gl = 0, EBO_gl = 0;
+        // For GPU_WU: VBO_gl as a texture buffer and EBO_gl as per-instance edges; false if the
+        // positions exceed GL_MAX_TEXTURE_BUFFER_SIZE, then the mode is drawn with drawWithGL
+        unsigned int VAO_gpu = 0, positionTexture = 0;
+        bool gpuLinesSupported = false;
 
         // The currently active rendering mode
         RenderMode currentRenderMode;
 
+        // Segments the CPU rasterized modes draw
+        enum WuEdgeSource {
+            FACE_POLYGONS, // Clip each face polygon and draw its outline (shared edges twice)
+            UNIQUE_EDGES   // Clip and draw each entry of edge_indices once
+        };
+        WuEdgeSource wuEdgeSource = UNIQUE_EDGES;
+
         // Mesh();
         Mesh(const std::string& name_);
-        bool loadFromOBJ(const std::string& filename);
-        void buildHalfEdge();
+
+        // Meshes own GL objects, so they are moved, never copied; a move hands the
+        // GL names over and leaves the source without any
+        Mesh(const Mesh&) = delete;
+        Mesh& operator=(const Mesh&) = delete;
+        Mesh(Mesh&& other) noexcept;
+        Mesh& operator=(Mesh&& other) noexcept;
+        // Needs the GL context setupMesh() ran in, if it ran
+        ~Mesh();
+        // Load points, faces, half-edges and edge list, from the cache when it is up to date
+        bool load(const std::string& filename, const MeshLoadOptions& options = MeshLoadOptions());
+        // threads: OBJ parser threads (1 = serial, 0 = all hardware threads)
+        bool loadFromOBJ(const std::string& filename, unsigned threads = 1);
+        // threads: half-edge build threads (1 = serial, 0 = all hardware threads)
+        void buildHalfEdge(unsigned threads = 1);
+        void buildEdgeList();
+        // One-ring adjacency for O(valence) vertex queries; built on first call
+        const VertexOneRing& vertexOneRing(unsigned threads = 1);
 
         void translate(const glm::vec3& trans);
         void rotate(float angle, const glm::vec3& axis);
@@ -74,12 +143,61 @@ class Mesh {
             this->shader = shader;
             this->shader->activate();
         }
-        void setupMesh();
+        // Create the GL objects, with buffers from the scene's pool
+        void setupMesh(GpuBufferPool& pool);
+        // Delete the GL objects setupMesh() created; no GL calls if there are none
+        void destroy();
 
         void setRenderMode(RenderMode newMode);
-        // If XIAOLIN_WU use this function
-        void drawWithXiaolinWu(
+        // CPU rasterizer of the current mode, nullptr for the hardware modes
+        const LineRasterizer* lineRasterizer() const;
+        // If LINES or POINTS (or GPU_WU without gpuLinesSupported) use this function; GL draws are scissored to the viewport
+        void drawWithGL(
             Shader* shader,
+            const glm::mat4& model,
+            const glm::mat4& view,
+            const glm::mat4& projection,
+            int screenHeight,
+            const glm::vec4& lineColor,
+            const ViewportRect& viewport
+        );
+        // If GPU_WU use this function: one instanced quad per edge, MVP as a uniform, Wu-style
+        // coverage in shaders/wu_line_gpu.frag; the CPU cost does not depend on the mesh size
+        void drawGpuLines(
+            Shader* shader,
+            const glm::mat4& model,
+            const glm::mat4& view,
+            const glm::mat4& projection,
+            int screenWidth,
+            int screenHeight,
+            const glm::vec4& lineColor,
+            const ViewportRect& viewport
+        );
+        // If XIAOLIN_WU, BRESENHAM or DDA use this function: one GL point per rasterized pixel,
+        // streamed into gpuPool's shared buffer (the caller ends the frame with GpuBufferPool::endFrame())
+        void drawRasterizedLines(
+            Shader* shader,
+            const glm::mat4& model,
+            const glm::mat4& view,
+            const glm::mat4& projection,
+            int screenWidth,
+            int screenHeight,
+            const glm::vec4& lineColor,
+            const ViewportRect& viewport
+        );
+        // Project, clip and Wu-rasterize into a CPU tile framebuffer (no GL calls); tiles run on rasterPool
+        void drawToFramebuffer(
+            const glm::mat4& model,
+            const glm::mat4& view,
+            const glm::mat4& projection,
+            int screenWidth,
+            int screenHeight,
+            const glm::vec4& lineColor,
+            const ViewportRect& viewport,
+            TileFramebuffer& framebuffer
+        );
+        // CPU half of drawRasterizedLines: project, clip and rasterize into wu_vertex_buffer (no GL calls)
+        void buildLineVertices(
             const glm::mat4& model,
             const glm::mat4& view,
             const glm::mat4& projection,
@@ -89,12 +207,21 @@ class Mesh {
             const ViewportRect& viewport
         );
         const std::string& getName() const { return name; }
-    // Project all mesh vertices to screen space
-    std::vector<glm::vec2> projectToScreenSpace(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, int screenWidth, int screenHeight);
+    // Project all mesh vertices to screen space into `projected` (one combined MVP, SIMD when available)
+    const ProjectedVertices& projectToScreenSpace(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, int screenWidth, int screenHeight);
     struct ClipResult {
         std::vector<std::pair<glm::vec2, glm::vec2>> visibleEdges;
         std::vector<std::pair<glm::vec2, glm::vec2>> boundarySegments;
     };
+    // The clip functions take screenVerts from projectToScreenSpace(): edges and faces crossing the near or
+    // far plane are clipped in clip space from positionsSoA before the 2D clipping
     // Clip all mesh edges to the viewport, return both visible edge segments and boundary segments (in screen space)
-    ClipResult clipToViewport(const std::vector<glm::vec2>& screenVerts, const ViewportRect& viewport);
+    ClipResult clipToViewport(const ProjectedVertices& screenVerts, const ViewportRect& viewport);
+    // Clip every face polygon to the viewport in one batch, return the outline segments of the clipped polygons
+    ClipResult clipFacesToViewport(const ProjectedVertices& screenVerts, const ViewportRect& viewport);
+    // Clip all mesh edges to an arbitrary (possibly concave) screen-space region; a crossing edge can yield several pieces
+    ClipResult clipToRegion(const ProjectedVertices& screenVerts, const WA_ClipRegion& region);
+    // Rasterize clipped segments with the given algorithm and append them to wu_vertex_buffer.
+    // With rasterPool the segments are split across its threads; the output is identical to the serial one.
+    void rasterizeSegments(const ClipResult& segments, const glm::vec4& lineColor, const LineRasterizer& rasterizer);
 };
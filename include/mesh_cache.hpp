@@ -0,0 +1,60 @@
+/**
+ * @file mesh_cache.hpp
+ * @brief Versioned binary cache of loaded meshes and their half-edge structure.
+ *
+ * A cache file stores positions, CSR face indices, the half-edge
+ * origin/twin/next/face arrays, per-vertex and per-face half-edges and the
+ * unique edge list, so a mesh can be restored without parsing the OBJ text
+ * or rebuilding adjacency. It lives next to the source file and is only
+ * used while the source size, modification time and content hash match.
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+
+class Mesh;
+
+/**
+ * @brief Identifies the exact source file a cache was built from.
+ */
+struct MeshCacheKey {
+    uint64_t sourceSize = 0;
+    int64_t sourceMtime = 0;  ///< Modification time in file clock ticks
+    uint64_t sourceHash = 0;  ///< 64-bit hash of the file contents
+};
+
+/**
+ * @brief Path of the cache file for a source mesh (source path + ".cgmc").
+ */
+std::string meshCachePathFor(const std::string& sourcePath);
+
+/**
+ * @brief Computes the cache key of a source file.
+ * @param sourcePath Path to the OBJ file.
+ * @param key Output key.
+ * @param withHash Also hash the contents (reads the whole file).
+ * @return False if the file cannot be read.
+ */
+bool computeMeshCacheKey(const std::string& sourcePath, MeshCacheKey& key, bool withHash = true);
+
+/**
+ * @brief Restores a mesh from a cache file if it matches the source.
+ *
+ * The size and modification time are checked first; the content hash is
+ * only computed when both match.
+ *
+ * @param cachePath Path to the cache file.
+ * @param sourcePath Path to the OBJ file the cache must match.
+ * @param mesh Mesh to fill (points, faces, half-edges, edge list).
+ * @return True if the cache was valid and the mesh was restored.
+ */
+bool readMeshCache(const std::string& cachePath, const std::string& sourcePath, Mesh& mesh);
+
+/**
+ * @brief Writes a cache file for a mesh whose half-edge structure is built.
+ * @param cachePath Path to the cache file (written atomically via a temporary).
+ * @param key Key of the source file.
+ * @param mesh Mesh to store.
+ * @return True on success.
+ */
+bool writeMeshCache(const std::string& cachePath, const MeshCacheKey& key, const Mesh& mesh);
@@ -0,0 +1,69 @@
+/**
+ * @file obj_loader.hpp
+ * @brief Single-pass, memory-mapped Wavefront OBJ loader.
+ */
+#pragma once
+#include <string>
+#include <vector>
+#include "utils.hpp"
+
+class ThreadPool;
+
+/**
+ * @brief Geometry read from an OBJ file: vertex positions and CSR faces.
+ */
+struct ObjMeshData {
+    std::vector<Point> points; ///< Vertex positions in file order
+    FaceList faces;            ///< Faces as 0-based vertex indices
+
+    void clear() {
+        points.clear();
+        faces.clear();
+    }
+};
+
+/**
+ * @brief Parses OBJ text held in memory in a single pass.
+ *
+ * Only `v` and `f` records are read; face corners may be written as
+ * `v`, `v/vt`, `v//vn` or `v/vt/vn`, and negative indices are resolved
+ * relative to the vertices read so far. Everything after `#` is ignored.
+ *
+ * @param begin Start of the text.
+ * @param end One past the end of the text (no terminator needed).
+ * @param out Output geometry (cleared first).
+ * @return False, with out cleared, if a face index is 0, not an integer or
+ *         beyond the int range.
+ */
+bool parseOBJ(const char* begin, const char* end, ObjMeshData& out);
+
+/**
+ * @brief Parses OBJ text on a thread pool; output is identical to parseOBJ().
+ *
+ * The text is split into newline-aligned chunks that are parsed
+ * independently, then stitched together using prefix sums of the per-chunk
+ * vertex, face and index counts.
+ *
+ * @param begin Start of the text.
+ * @param end One past the end of the text.
+ * @param out Output geometry (cleared first).
+ * @param pool Worker threads to parse on.
+ * @return False, with out cleared, under the same conditions as parseOBJ().
+ */
+bool parseOBJParallel(const char* begin, const char* end, ObjMeshData& out, ThreadPool& pool);
+
+/**
+ * @brief Checks that every face index refers to an existing vertex.
+ * @param data Parsed geometry.
+ * @return True if all indices are in range.
+ */
+bool validateOBJIndices(const ObjMeshData& data);
+
+/**
+ * @brief Memory-maps an OBJ file and parses it.
+ * @param filename Path to the OBJ file.
+ * @param out Output geometry (cleared first).
+ * @param threads Parser threads; 1 parses serially, 0 uses every hardware thread.
+ * @return True if the file could be read and parsed and all face indices are valid.
+ */
+bool loadOBJ(const std::string& filename, ObjMeshData& out, unsigned threads = 1);
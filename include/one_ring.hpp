@@ -0,0 +1,82 @@
+/**
+ * @file one_ring.hpp
+ * @brief Precomputed vertex one-ring adjacency in CSR layout.
+ */
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "half_edge.hpp"
+
+class ThreadPool;
+
+/**
+ * @brief Read-only view of a contiguous run of indices.
+ */
+struct IndexSpan {
+    const HEIndex* first = nullptr;
+    size_t count = 0;
+
+    const HEIndex* begin() const { return first; }
+    const HEIndex* end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    HEIndex operator[](size_t i) const { return first[i]; }
+};
+
+/**
+ * @brief One-ring tables built once from a HalfEdgeMesh.
+ *
+ * For vertex v, ringOffsets[v] .. ringOffsets[v+1]-1 index ringFaces and
+ * ringOutgoing, and incidentOffsets[v] .. incidentOffsets[v+1]-1 index
+ * incidentEdges. Faces appear in the order getFacesOfVertex() visits them
+ * and incident edges are sorted like getEdgesOfVertex().
+ */
+struct VertexOneRing {
+    std::vector<HEIndex> prev;            ///< Per half-edge: previous half-edge in its face
+    std::vector<HEIndex> ringOffsets;     ///< Per vertex start into ringFaces/ringOutgoing, plus sentinel
+    std::vector<HEIndex> ringFaces;       ///< Faces around each vertex
+    std::vector<HEIndex> ringOutgoing;    ///< Half-edge leaving the vertex in the matching face
+    std::vector<HEIndex> incidentOffsets; ///< Per vertex start into incidentEdges, plus sentinel
+    std::vector<HEIndex> incidentEdges;   ///< Half-edges starting or ending at the vertex
+
+    size_t vertexCount() const { return ringOffsets.empty() ? 0 : ringOffsets.size() - 1; }
+    bool empty() const { return ringOffsets.empty(); }
+
+    void clear() {
+        prev.clear();
+        ringOffsets.clear();
+        ringFaces.clear();
+        ringOutgoing.clear();
+        incidentOffsets.clear();
+        incidentEdges.clear();
+    }
+};
+
+/**
+ * @brief Builds the one-ring tables; O(half-edges) time and memory.
+ * @param mesh Half-edge mesh.
+ * @param ring Output tables.
+ * @param pool Optional thread pool; vertices are processed in parallel.
+ */
+void buildVertexOneRing(const HalfEdgeMesh& mesh, VertexOneRing& ring, ThreadPool* pool = nullptr);
+
+/**
+ * @brief Faces around vertex v; same elements and order as getFacesOfVertex().
+ */
+inline IndexSpan facesOfVertex(const VertexOneRing& ring, HEIndex v) {
+    return {ring.ringFaces.data() + ring.ringOffsets[v], ring.ringOffsets[v + 1] - ring.ringOffsets[v]};
+}
+
+/**
+ * @brief Outgoing half-edge of vertex v in each face of facesOfVertex().
+ */
+inline IndexSpan outgoingEdgesOfVertex(const VertexOneRing& ring, HEIndex v) {
+    return {ring.ringOutgoing.data() + ring.ringOffsets[v], ring.ringOffsets[v + 1] - ring.ringOffsets[v]};
+}
+
+/**
+ * @brief Half-edges starting or ending at v; same result as getEdgesOfVertex().
+ */
+inline IndexSpan edgesOfVertex(const VertexOneRing& ring, HEIndex v) {
+    return {ring.incidentEdges.data() + ring.incidentOffsets[v], ring.incidentOffsets[v + 1] - ring.incidentOffsets[v]};
+}
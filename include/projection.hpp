@@ -0,0 +1,130 @@
+/**
+ * @file projection.hpp
+ * @brief Batched object-to-screen projection of vertex positions.
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "utils.hpp"
+
+/**
+ * @brief Vertex positions split into one array per coordinate (structure of arrays).
+ */
+struct SoAPositions {
+    std::vector<float> x, y, z;
+
+    size_t size() const { return x.size(); }
+    void assign(const std::vector<Point>& points);
+};
+
+/**
+ * @brief Outcode bits of a clip-space position (x, y, z, w), one per frustum plane.
+ */
+enum ClipPlaneBits : uint8_t {
+    CLIP_LEFT = 1,    ///< x < -w
+    CLIP_RIGHT = 2,   ///< x > w
+    CLIP_BOTTOM = 4,  ///< y < -w
+    CLIP_TOP = 8,     ///< y > w
+    CLIP_NEAR = 16,   ///< z + w <= 0: in front of the near plane or behind the camera
+    CLIP_FAR = 32,    ///< z > w
+    CLIP_DEPTH = CLIP_NEAR | CLIP_FAR
+};
+
+/**
+ * @brief Screen-space positions of a batch of vertices.
+ *
+ * clipCodes[i] holds the ClipPlaneBits of vertex i. With CLIP_NEAR set the
+ * vertex cannot be divided by w; screen[i] is then meaningless (but finite)
+ * and edges or faces using it must go through clipEdgeToFrustum() or
+ * clipFaceToFrustum(), which clip in homogeneous space before the divide.
+ * The projection parameters are kept for those two functions.
+ */
+struct ProjectedVertices {
+    std::vector<glm::vec2> screen;
+    std::vector<uint8_t> clipCodes;
+    glm::mat4 mvp = glm::mat4(1.0f);
+    float halfWidth = 0.0f, halfHeight = 0.0f;
+
+    size_t size() const { return screen.size(); }
+    bool visible(size_t i) const { return !(clipCodes[i] & CLIP_NEAR); }
+};
+
+/**
+ * @brief Implementations of projectPositions().
+ */
+enum class ProjectionKernel {
+    Auto,   ///< Best kernel the CPU supports
+    Scalar, ///< Portable C++
+    SSE,    ///< 4 vertices per step (x86-64 baseline)
+    AVX2    ///< 8 vertices per step, used only if the CPU reports AVX2
+};
+
+/**
+ * @brief Kernel that Auto resolves to on this CPU (checked once at runtime).
+ */
+ProjectionKernel bestProjectionKernel();
+
+/**
+ * @brief Human-readable kernel name.
+ */
+const char* projectionKernelName(ProjectionKernel kernel);
+
+/**
+ * @brief Projects every position with a combined model-view-projection matrix.
+ *
+ * Screen coordinates follow projectWorldToScreen(): x to the right, y down,
+ * origin at the top-left of a screenWidth x screenHeight window. out is
+ * resized to positions.size() and reused between calls, so a persistent
+ * out never reallocates once it has reached the mesh size.
+ *
+ * @param positions Object-space positions.
+ * @param mvp projection * view * model, computed once per frame.
+ * @param screenWidth Window width in pixels.
+ * @param screenHeight Window height in pixels.
+ * @param out Screen positions and frustum outcodes.
+ * @param kernel Implementation; unsupported choices fall back to Scalar.
+ */
+void projectPositions(
+    const SoAPositions& positions,
+    const glm::mat4& mvp,
+    int screenWidth,
+    int screenHeight,
+    ProjectedVertices& out,
+    ProjectionKernel kernel = ProjectionKernel::Auto
+);
+
+/**
+ * @brief Screen-space end points of the edge between vertices a and b.
+ *
+ * Edges entirely outside one frustum plane are rejected from the outcodes.
+ * Edges crossing the near or far plane are clipped against it in
+ * homogeneous clip space before the perspective divide; the left, right,
+ * bottom and top planes are left to the 2D viewport clipper.
+ *
+ * @param positions The positions out was projected from.
+ * @param projected Output of projectPositions() for positions.
+ * @return False if nothing of the edge is between the near and far planes.
+ */
+bool clipEdgeToFrustum(const SoAPositions& positions, const ProjectedVertices& projected, size_t a, size_t b,
+                       glm::vec2& screenA, glm::vec2& screenB);
+
+/**
+ * @brief Clip-space working storage of clipFaceToFrustum(), reused across faces.
+ */
+struct FrustumClipScratch {
+    std::vector<glm::vec4> polygon; ///< Face being clipped
+    std::vector<glm::vec4> next;    ///< Output of the current plane's pass
+};
+
+/**
+ * @brief Screen-space polygon of a face, clipped like clipEdgeToFrustum().
+ *
+ * @param face Vertex indices of the face.
+ * @param count Number of vertices.
+ * @param out Receives the clipped polygon (at most count + 2 vertices).
+ * @param scratch Caller-owned buffers, so faces crossing a depth plane do not allocate.
+ * @return Vertex count of out; 0 if the face is rejected.
+ */
+size_t clipFaceToFrustum(const SoAPositions& positions, const ProjectedVertices& projected, const int* face, size_t count,
+                         std::vector<glm::vec2>& out, FrustumClipScratch& scratch);
@@ -0,0 +1,29 @@
+/**
+ * @file radix_sort.hpp
+ * @brief Stable LSD radix sort of (64-bit key, 32-bit value) pairs.
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief Key/value pair sorted by radixSortPairs().
+ */
+struct KeyIndex {
+    uint64_t key;
+    uint32_t index;
+};
+
+/**
+ * @brief Sorts pairs by key, keeping equal keys in input order.
+ *
+ * Only the lowest keyBits bits of the key take part, in 8-bit digits, so
+ * narrower keys need fewer passes.
+ *
+ * @param items Pairs to sort (sorted in place).
+ * @param keyBits Number of significant key bits (1..64).
+ * @param pool Optional thread pool; histograms and scatters run per chunk.
+ */
+void radixSortPairs(std::vector<KeyIndex>& items, unsigned keyBits, ThreadPool* pool = nullptr);
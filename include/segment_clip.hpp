@@ -0,0 +1,78 @@
+/**
+ * @file segment_clip.hpp
+ * @brief Clipping of line segments against the viewport rectangle.
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "weiler-atherton-clip.hpp"
+
+/**
+ * @brief Outcome of clipping one segment.
+ */
+enum SegmentClass : uint8_t {
+    SEGMENT_REJECTED = 0, ///< Nothing of the segment is inside the viewport
+    SEGMENT_VISIBLE = 1,  ///< Clipped segment lies (partly) inside the viewport
+    SEGMENT_BORDER = 2    ///< Clipped segment runs along one side of the viewport
+};
+
+/**
+ * @brief Implementations of clipSegments().
+ */
+enum class SegmentClipKernel {
+    Auto,   ///< Best kernel the CPU supports
+    Scalar, ///< Portable C++
+    SSE,    ///< 4 segments per step (x86-64 baseline)
+    AVX2    ///< 8 segments per step, used only if the CPU reports AVX2
+};
+
+/**
+ * @brief Kernel that Auto resolves to on this CPU (checked once at runtime).
+ */
+SegmentClipKernel bestSegmentClipKernel();
+
+/**
+ * @brief Human-readable kernel name.
+ */
+const char* segmentClipKernelName(SegmentClipKernel kernel);
+
+/**
+ * @brief Clips segment ab to the viewport in place.
+ *
+ * Outcodes accept segments with both ends inside and reject segments with
+ * both ends beyond the same side; the rest are clipped with Liang-Barsky.
+ *
+ * @return False if nothing of the segment is left.
+ */
+bool clipSegmentToViewport(glm::vec2& a, glm::vec2& b, const WA_Viewport& vp);
+
+/**
+ * @brief True if both points lie on the same side of the viewport rectangle (within 1e-3).
+ */
+bool onSameViewportSide(const glm::vec2& a, const glm::vec2& b, const WA_Viewport& vp);
+
+/**
+ * @brief Segments in structure-of-arrays layout, clipped in place by clipSegments().
+ */
+struct SegmentBatch {
+    std::vector<float> x0, y0, x1, y1;
+    std::vector<uint8_t> segmentClass; ///< SegmentClass of each segment after clipSegments()
+
+    size_t size() const { return x0.size(); }
+    void resize(size_t count);
+};
+
+/**
+ * @brief Clips every segment of the batch to the viewport.
+ *
+ * Each segment gets the result of clipSegmentToViewport() and is then
+ * classified as visible or border with onSameViewportSide(); the SIMD
+ * kernels clip 4 or 8 segments per step without branches and classify
+ * exactly like the scalar one.
+ *
+ * @param segments Segments to clip; coordinates of rejected ones are left unspecified.
+ * @param vp Viewport rectangle.
+ * @param kernel Implementation; unsupported choices fall back to Scalar.
+ */
+void clipSegments(SegmentBatch& segments, const WA_Viewport& vp, SegmentClipKernel kernel = SegmentClipKernel::Auto);
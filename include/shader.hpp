@@ -74,6 +74,20 @@ public:
      * @param val Vector value to set.
      */
     void setVec2(const std::string& name, const glm::vec2& val);
+
+    /**
+     * @brief Sets a float uniform in the shader.
+     * @param name Name of the uniform variable.
+     * @param val Value to set.
+     */
+    void setFloat(const std::string& name, float val);
+
+    /**
+     * @brief Sets an int (or sampler unit) uniform in the shader.
+     * @param name Name of the uniform variable.
+     * @param val Value to set.
+     */
+    void setInt(const std::string& name, int val);
 };
 
 
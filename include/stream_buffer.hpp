@@ -0,0 +1,113 @@
+/**
+ * @file stream_buffer.hpp
+ * @brief Ring-buffered vertex buffer for data uploaded every frame.
+ */
+#pragma once
+#include <cstddef>
+
+// Forward declaration to avoid including glad in header
+typedef struct __GLsync* GLsync;
+
+/**
+ * @brief A GL_ARRAY_BUFFER split into kRegions regions written in turn.
+ *
+ * Each frame goes to the next region, so the CPU fills one region while
+ * the GPU may still read the two before it. A frame is every upload() up to
+ * the next fence(); its uploads are packed one after another into the same
+ * region, so several meshes can stream into one buffer. In Persistent mode a fence
+ * placed after the draws that read a region is waited on before the region
+ * is written again; in Orphaning mode the buffer is orphaned whenever the
+ * ring wraps, so the driver hands out fresh storage instead of stalling.
+ *
+ * Requires a current GL context for every call. Draw the uploaded elements
+ * starting at the index upload() returns; buffer() changes when an upload
+ * does not fit and the buffer is reallocated, so vertex attribute pointers
+ * have to be set again then.
+ */
+class StreamBuffer {
+public:
+    static constexpr int kRegions = 3;
+
+    /**
+     * @brief How regions are written.
+     */
+    enum class Mode {
+        Auto,       ///< Persistent if the context supports buffer storage, Orphaning otherwise
+        Orphaning,  ///< GL 3.3: unsynchronized glMapBufferRange, orphaning the buffer each time the ring wraps
+        Persistent, ///< glBufferStorage mapped once with GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT, fences per region
+        SubData     ///< glBufferSubData into a single region, as uploads were done before (for comparison)
+    };
+
+    /**
+     * @brief Cost of the last upload().
+     */
+    struct UploadStats {
+        size_t bytes = 0;     ///< Bytes copied into the buffer
+        double waitMs = 0.0;  ///< Time blocked on fences, maps and orphaning
+        bool reallocated = false;
+    };
+
+    /**
+     * @brief Creates the buffer; true on success.
+     * @param elementSize Size of one element (vertex) in bytes.
+     * @param regionElements Initial capacity of each region in elements.
+     * @param mode Upload strategy; Persistent falls back to Orphaning if unsupported.
+     */
+    bool init(size_t elementSize, size_t regionElements, Mode mode = Mode::Auto);
+
+    /**
+     * @brief Copies count elements after the earlier uploads of this frame; the
+     * first upload of a frame moves to the next region. Grows the regions to
+     * 1.5x the frame's demand when they are too small.
+     * @return Index of the first uploaded element in the buffer.
+     */
+    size_t upload(const void* data, size_t count);
+
+    /**
+     * @brief Ends the frame, after the draws that read its uploads.
+     */
+    void fence();
+
+    /**
+     * @brief Reallocates every region to hold regionElements elements; call between frames.
+     */
+    bool resize(size_t regionElements);
+
+    /**
+     * @brief Deletes the buffer and fences.
+     */
+    void destroy();
+
+    unsigned int buffer() const { return id; }
+    Mode mode() const { return activeMode; }
+    const char* modeName() const;
+    /// GPU memory held by the buffer in bytes
+    size_t capacityBytes() const;
+    /// Elements each region holds
+    size_t regionCapacity() const { return regionElements; }
+    /// Elements uploaded in the current (or, after fence(), the last) frame
+    size_t frameElements() const { return cursor; }
+    const UploadStats& lastUpload() const { return last; }
+
+private:
+    bool allocate(size_t elements);
+    void deleteFences();
+
+    unsigned int id = 0;
+    Mode activeMode = Mode::Orphaning;
+    size_t elementSize = 0;
+    size_t regionElements = 0;
+    int nextRegion = 0;
+    int region = 0;          // Region of the current frame
+    size_t cursor = 0;       // Elements written into it so far
+    bool frameOpen = false;  // An upload happened since the last fence()
+    void* mapped = nullptr;
+    GLsync fences[kRegions] = {};
+    UploadStats last;
+};
+
+/**
+ * @brief True if the current context can create persistently mapped buffers
+ * (GL 4.4 or GL_ARB_buffer_storage); loads glBufferStorage on first use.
+ */
+bool streamBufferPersistentSupported();
@@ -0,0 +1,94 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Small fork-join thread pool for data-parallel loops.
+ */
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Persistent worker threads that execute indexed tasks.
+ *
+ * run() hands out task indices to the workers and to the calling thread and
+ * returns once every task has finished. Tasks must not call run() on the
+ * same pool.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Creates a pool that runs on threadCount threads in total.
+     * @param threadCount Total threads including the caller; 0 means one per hardware thread.
+     */
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Number of threads that execute tasks, including the caller.
+     */
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    /**
+     * @brief Runs fn(i) for every i in [0, taskCount) and waits for completion.
+     */
+    void run(size_t taskCount, const std::function<void(size_t)>& fn);
+
+    /**
+     * @brief Splits [0, count) into contiguous ranges and runs fn(begin, end, chunk) on each.
+     *
+     * Chunk c always covers the same range for a given count and chunkCount,
+     * so results written per chunk can be combined deterministically.
+     *
+     * @param count Number of items.
+     * @param fn Callable taking (size_t begin, size_t end, size_t chunk).
+     * @param chunkCount Number of ranges; 0 means size().
+     */
+    template <class F>
+    void parallelFor(size_t count, F&& fn, size_t chunkCount = 0) {
+        if (chunkCount == 0) chunkCount = size();
+        if (chunkCount > count) chunkCount = count;
+        if (chunkCount <= 1) {
+            if (count > 0) fn(size_t(0), count, size_t(0));
+            return;
+        }
+        run(chunkCount, [&](size_t c) {
+            fn(chunkBegin(count, chunkCount, c), chunkBegin(count, chunkCount, c + 1), c);
+        });
+    }
+
+    /**
+     * @brief First item of chunk c when count items are split into chunkCount ranges.
+     */
+    static size_t chunkBegin(size_t count, size_t chunkCount, size_t c) {
+        return count / chunkCount * c + std::min(c, count % chunkCount);
+    }
+
+    /**
+     * @brief Resolves a user-supplied thread count (0 = hardware concurrency).
+     */
+    static unsigned resolveThreadCount(unsigned requested);
+
+private:
+    void workerLoop();
+    void drainTasks();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable jobDone;
+
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobTaskCount = 0;
+    std::atomic<size_t> nextTask{0};
+    size_t busyWorkers = 0;
+    unsigned long long generation = 0;
+    bool stopping = false;
+};
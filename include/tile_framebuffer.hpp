@@ -0,0 +1,76 @@
+/**
+ * @file tile_framebuffer.hpp
+ * @brief CPU-side RGBA framebuffer that rasterizes Wu lines tile by tile.
+ */
+#pragma once
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+class ThreadPool;
+
+/**
+ * @brief Screen-sized RGBA8 image split into square tiles.
+ *
+ * Segments are first binned to the tiles they cross; every tile is then
+ * rasterized by one thread, visiting its segments in submission order.
+ * A pixel belongs to exactly one tile, so tiles run in parallel without
+ * locks and the result does not depend on the thread count.
+ *
+ * Pixels hold premultiplied color: lines are composited with "over"
+ * blending onto a transparent background, so the image is drawn on top
+ * of the scene with glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA).
+ */
+class TileFramebuffer {
+public:
+    static constexpr int kTileSize = 64;
+
+    /**
+     * @brief Sets the size in pixels; contents are undefined until clear().
+     */
+    void resize(int width, int height);
+
+    /**
+     * @brief Makes every pixel transparent black.
+     * @param pool Optional thread pool; tiles are cleared in parallel.
+     */
+    void clear(ThreadPool* pool = nullptr);
+
+    /**
+     * @brief Wu-rasterizes screen-space segments in one color.
+     *
+     * Pixels with coverage at most 0.05 are skipped, as in the point path.
+     *
+     * @param segments Segments in screen coordinates (x right, y down).
+     * @param color Line color; alpha is ignored, coverage is used instead.
+     * @param pool Optional thread pool; tiles are rasterized in parallel.
+     */
+    void drawSegments(const std::vector<std::pair<glm::vec2, glm::vec2>>& segments, const glm::vec4& color,
+                      ThreadPool* pool = nullptr);
+
+    int width() const { return imageWidth; }
+    int height() const { return imageHeight; }
+    int tilesX() const { return tileColumns; }
+    int tilesY() const { return tileRows; }
+
+    /**
+     * @brief Row-major RGBA8 pixels, top row first, 4 bytes per pixel.
+     */
+    const uint8_t* pixels() const { return rgba.data(); }
+
+    /**
+     * @brief Segment references created by the last drawSegments() call (one per tile crossed).
+     */
+    size_t binnedSegments() const { return binTotal; }
+
+private:
+    int imageWidth = 0, imageHeight = 0;
+    int tileColumns = 0, tileRows = 0;
+    std::vector<uint8_t> rgba;
+    std::vector<std::vector<uint32_t>> bins; // Per tile: indices into the current segment list
+    size_t binTotal = 0;
+
+    void binSegments(const std::vector<std::pair<glm::vec2, glm::vec2>>& segments);
+    void rasterizeTile(int tile, const std::vector<std::pair<glm::vec2, glm::vec2>>& segments, const glm::vec4& color);
+};
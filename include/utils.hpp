@@ -20,6 +20,28 @@ struct Point {
     float x, y, z;
 };
 
+/**
+ * @brief Polygon list in compressed sparse row (CSR) layout.
+ *
+ * The vertex indices of face f are indices[offsets[f]] .. indices[offsets[f+1]-1].
+ */
+struct FaceList {
+    std::vector<int> offsets{0}; ///< Start of each face in indices, plus one end sentinel
+    std::vector<int> indices;    ///< Concatenated 0-based vertex indices of all faces
+
+    size_t size() const { return offsets.size() - 1; }
+    bool empty() const { return size() == 0; }
+    int faceSize(size_t f) const { return offsets[f + 1] - offsets[f]; }
+    const int* face(size_t f) const { return indices.data() + offsets[f]; }
+
+    void clear() {
+        offsets.assign(1, 0);
+        indices.clear();
+    }
+    // Close the face made of the indices appended since the previous call
+    void endFace() { offsets.push_back(static_cast<int>(indices.size())); }
+};
+
 /**
  * @brief Loads vertex positions from an OBJ file.
  * @param filename Path to the OBJ file.
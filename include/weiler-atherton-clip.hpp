@@ -1,6 +1,9 @@
 #pragma once
+#include <cstddef>
 #include <vector>
 #include <glm/glm.hpp>
+#include "projection.hpp"
+#include "utils.hpp"
 
 struct WA_Point {
     float x, y;
@@ -19,3 +22,86 @@ struct WA_ClipResult {
 };
 
 WA_ClipResult weiler_atherton_clip(const WA_Polygon& poly, const WA_Viewport& vp);
+
+// Clipped polygons of a whole mesh in CSR layout. The arrays only grow, so
+// a persistent instance stops allocating after the first frames; entries
+// past polygonCount are stale.
+struct WA_ClippedPolygons {
+    std::vector<glm::vec2> points;  // Vertices of polygon p: points[offsets[p]] .. points[offsets[p+1]-1]
+    std::vector<int> offsets{0};    // polygonCount + 1 entries are valid
+    std::vector<int> faces;         // Source face of polygon p
+    std::vector<glm::vec2> scratch; // Ping-pong buffers for the per-side passes
+    std::vector<glm::vec2> depthClipped; // Face clipped to the near/far planes by clipFaceToFrustum()
+    FrustumClipScratch depthScratch;     // Clip-space buffers of clipFaceToFrustum()
+    size_t polygonCount = 0;
+    size_t trivialAccepts = 0;      // Faces fully inside, copied without edge work
+    size_t trivialRejects = 0;      // Faces fully outside one side, dropped without edge work
+    size_t depthClips = 0;          // Faces crossing the near or far plane, clipped before the divide
+
+    size_t size() const { return polygonCount; }
+    size_t polygonSize(size_t p) const { return static_cast<size_t>(offsets[p + 1] - offsets[p]); }
+    const glm::vec2* polygon(size_t p) const { return points.data() + offsets[p]; }
+};
+
+// Clip every face of a CSR polygon list against the viewport in one call.
+// Faces outside one frustum plane are dropped from the clip-space outcodes.
+// Faces crossing the near or far plane are first clipped in clip space with
+// clipFaceToFrustum() when positions (the ones screen was projected from)
+// are given, and skipped otherwise. Faces whose vertex outcodes show them
+// fully inside or fully outside the viewport skip the edge passes, and the
+// rest only run the passes for sides a vertex lies beyond. Each output
+// polygon matches weiler_atherton_clip() on the same (depth-clipped) face.
+void weiler_atherton_clip_faces(const FaceList& faces, const ProjectedVertices& screen, const WA_Viewport& vp,
+                                WA_ClippedPolygons& out, const SoAPositions* positions = nullptr);
+
+// A simple polygon (convex or concave, either winding) used as a clip
+// region, e.g. a lasso drawn over the viewport. Its edges are bucketed in a
+// uniform grid so that intersection and inside tests only visit edges near
+// the query, which keeps clip regions with hundreds of vertices cheap.
+class WA_ClipRegion {
+public:
+    // gridSize cells per axis; 0 picks about sqrt(vertex count), 1 disables the grid
+    explicit WA_ClipRegion(const WA_Polygon& boundary, int gridSize = 0);
+
+    // Boundary with positive signed area (the winding the clipper works in)
+    const WA_Polygon& boundary() const { return points; }
+    int gridSize() const { return cols; }
+    // Even-odd inside test
+    bool contains(float x, float y) const;
+    // Appends the indices of edges (i, i+1) stored in the cells the box overlaps, sorted and unique
+    void edgesNear(float x0, float y0, float x1, float y1, std::vector<int>& out) const;
+
+private:
+    WA_Polygon points;
+    float minX = 0, minY = 0, maxX = 0, maxY = 0;
+    float cellW = 1, cellH = 1;
+    int cols = 1, rows = 1;
+    std::vector<int> cellStart; // CSR: edges of cell c are cellEdges[cellStart[c]] .. cellEdges[cellStart[c+1]-1]
+    std::vector<int> cellEdges;
+    std::vector<int> rowStart;  // Same for the edges overlapping each horizontal band, for contains()
+    std::vector<int> rowEdges;
+
+    int column(float x) const;
+    int row(float y) const;
+};
+
+// Weiler-Atherton clipping of a simple subject polygon against a clip
+// region, both possibly concave. Intersections are inserted into both
+// boundaries and marked as entries or exits; output pieces follow the
+// subject from each entry and the clip boundary from each exit, so one
+// subject can produce several pieces. Pieces have positive signed area.
+std::vector<WA_Polygon> weiler_atherton_clip(const WA_Polygon& subject, const WA_ClipRegion& clip);
+
+// Working storage of weiler_atherton_clip_segment(), kept by callers that clip
+// many segments so the per-segment vectors are not allocated again each time
+struct WA_SegmentScratch {
+    std::vector<int> candidates;  // Clip edges near the segment
+    std::vector<float> crossings; // Parameters along the segment where it crosses them
+};
+
+// Parts of segment ab inside the clip region, appended to pieces in order from a to b
+void weiler_atherton_clip_segment(const WA_Point& a, const WA_Point& b, const WA_ClipRegion& clip,
+                                  std::vector<std::pair<WA_Point, WA_Point>>& pieces);
+// Same, with caller-owned scratch reused across calls
+void weiler_atherton_clip_segment(const WA_Point& a, const WA_Point& b, const WA_ClipRegion& clip,
+                                  std::vector<std::pair<WA_Point, WA_Point>>& pieces, WA_SegmentScratch& scratch);
@@ -3,6 +3,7 @@
  * @brief Implements Xiaolin Wu's anti-aliased line drawing algorithm.
  */
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <cmath>
 #include <algorithm> // For std::swap
@@ -24,6 +25,78 @@ inline double rfpart(double x) {
     return 1.0 - fpart(x);
 }
 
+/**
+ * @brief Draws an anti-aliased 2D line using Xiaolin Wu's algorithm, handing each pixel to a sink.
+ *
+ * emit(x, y, intensity) is called for every pixel in the order
+ * drawWuLine2D() lists them, so a caller can filter, color and store them
+ * wherever it likes without an intermediate vector. At most
+ * wuLinePixelCount(p0, p1) calls are made.
+ *
+ * @param p0 The starting 2D point (in screen coordinates).
+ * @param p1 The ending 2D point (in screen coordinates).
+ * @param emit Callable as emit(int x, int y, double intensity).
+ */
+template <class Emit>
+void rasterizeWuLine(glm::vec2 p0, glm::vec2 p1, Emit&& emit) {
+    bool steep = std::abs(p1.y - p0.y) > std::abs(p1.x - p0.x);
+
+    if (steep) {
+        std::swap(p0.x, p0.y);
+        std::swap(p1.x, p1.y);
+    }
+
+    // Left to right
+    if (p0.x > p1.x) {
+        std::swap(p0, p1);
+    }
+
+    // Pixels are emitted in screen coordinates whichever axis is major
+    auto plot = [&](int x, int y, double intensity) {
+        if (steep) emit(y, x, intensity);
+        else emit(x, y, intensity);
+    };
+
+    float dx = p1.x - p0.x;
+    float dy = p1.y - p0.y;
+    float gradient = (dx == 0.0f) ? 1.0f : dy / dx;
+
+    // First endpoint
+    int x_start = static_cast<int>(std::round(p0.x));
+    double y_start = p0.y + gradient * (x_start - p0.x);
+    int y_start_px = static_cast<int>(std::floor(y_start));
+    plot(x_start, y_start_px,     rfpart(y_start));
+    plot(x_start, y_start_px + 1,  fpart(y_start));
+
+    // Main loop
+    int x_end = static_cast<int>(std::round(p1.x));
+    double y = y_start + gradient; // First y-position after the starting endpoint
+
+    for (int x = x_start + 1; x < x_end; ++x) {
+        int ix = static_cast<int>(std::floor(y));
+        plot(x, ix,     rfpart(y));
+        plot(x, ix + 1,  fpart(y));
+        y += gradient;
+    }
+
+    // Last endpoint
+    double y_end = p1.y + gradient * (x_end - p1.x);
+    int y_end_px = static_cast<int>(std::floor(y_end));
+    plot(x_end, y_end_px,     rfpart(y_end));
+    plot(x_end, y_end_px + 1,  fpart(y_end));
+}
+
+/**
+ * @brief Number of pixels rasterizeWuLine() emits for a line, before any filtering.
+ */
+inline size_t wuLinePixelCount(glm::vec2 p0, glm::vec2 p1) {
+    const bool steep = std::abs(p1.y - p0.y) > std::abs(p1.x - p0.x);
+    const float a = steep ? p0.y : p0.x, b = steep ? p1.y : p1.x;
+    const int columns = std::abs(static_cast<int>(std::round(b)) - static_cast<int>(std::round(a))) + 1;
+    // Two endpoint columns (the same column twice for a one-column line)
+    return 2 * static_cast<size_t>(std::max(columns, 2));
+}
+
 /**
  * @brief Draws an anti-aliased 2D line using Xiaolin Wu's algorithm.
  *
@@ -31,4 +104,44 @@ inline double rfpart(double x) {
  * @param p1 The ending 2D point (in screen coordinates).
  * @return A vector of Pixel objects representing the line.
  */
-std::vector<Pixel> drawWuLine2D(glm::vec2 p0, glm::vec2 p1);
\ No newline at end of file
+std::vector<Pixel> drawWuLine2D(glm::vec2 p0, glm::vec2 p1);
+
+/**
+ * @brief One Wu line as columns along its major axis, with 8-bit coverage.
+ *
+ * Column i lies at major coordinate first + i and covers the pixels at
+ * minor[i] and minor[i] + 1 along the minor axis, with coverage upper[i]
+ * and lower[i] (0-255, summing to 255). The major axis is x, or y when
+ * steep is set. Buffers are reused between lines.
+ */
+struct WuColumns8 {
+    bool steep = false;
+    int first = 0;
+    std::vector<int32_t> minor;
+    std::vector<uint8_t> upper;
+    std::vector<uint8_t> lower;
+
+    size_t size() const { return minor.size(); }
+};
+
+/**
+ * @brief Xiaolin Wu's algorithm in 16.16 fixed point with 8-bit coverage.
+ *
+ * Covers the same columns as drawWuLine2D(), round(p0) to round(p1) along
+ * the major axis. The minor coordinate is accumulated as a 16.16 integer
+ * and coverage is its top 8 fraction bits, so no floor/round or floating
+ * point runs per column. With vectorized set, 8 columns are produced per
+ * step with SSE2 (scalar on other CPUs). Coordinates must stay within
+ * +-32767, which clipped screen coordinates do.
+ *
+ * @param p0 The starting 2D point (in screen coordinates).
+ * @param p1 The ending 2D point (in screen coordinates).
+ * @param out Columns of the line; previous contents are replaced.
+ * @param vectorized Use the SIMD inner loop when available.
+ */
+void drawWuLine2DFixed(glm::vec2 p0, glm::vec2 p1, WuColumns8& out, bool vectorized = true);
+
+/**
+ * @brief Expands columns to the Pixel list drawWuLine2D() would produce (intensity = coverage / 255).
+ */
+void appendWuPixels(const WuColumns8& columns, std::vector<Pixel>& out);
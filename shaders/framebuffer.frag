@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+// CPU framebuffer, row 0 at the top of the window
+uniform sampler2D u_framebuffer;
+
+void main() {
+    ivec2 size = textureSize(u_framebuffer, 0);
+    ivec2 texel = ivec2(gl_FragCoord.x, float(size.y) - gl_FragCoord.y);
+    if (texel.x >= size.x || texel.y < 0 || texel.y >= size.y) discard;
+    // Premultiplied color, blended with GL_ONE, GL_ONE_MINUS_SRC_ALPHA
+    FragColor = texelFetch(u_framebuffer, texel, 0);
+}
@@ -0,0 +1,19 @@
+#version 330 core
+out vec4 FragColor;
+
+noperspective in vec2 vLinePos;
+flat in float vLength;
+
+uniform vec4 u_color;
+uniform float u_lineWidth;
+
+void main() {
+    // Box-filtered coverage of this pixel by the line: like Wu, a 1 px line
+    // splits its intensity between the two nearest pixels by distance
+    float across = clamp(0.5 * u_lineWidth + 0.5 - abs(vLinePos.y), 0.0, 1.0);
+    // The end points fade out over half a pixel either way
+    float along = clamp(min(vLinePos.x, vLength - vLinePos.x) + 0.5, 0.0, 1.0);
+    float coverage = across * along;
+    if (coverage <= 0.0) discard;
+    FragColor = vec4(u_color.rgb, u_color.a * coverage);
+}
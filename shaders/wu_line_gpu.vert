@@ -0,0 +1,54 @@
+#version 330 core
+// One instance per edge, drawn as a 4-vertex triangle strip: the edge is
+// projected here and expanded into a screen-aligned quad around it
+layout (location = 0) in uvec2 aEdge; // Vertex indices of the edge (per instance)
+
+uniform samplerBuffer u_positions; // Mesh positions, 3 R32F texels per vertex
+uniform mat4 u_mvp;
+uniform vec2 u_screenSize;
+uniform float u_lineWidth;         // In pixels
+
+// Fragment position relative to the line in pixels: x along it from the
+// first end point, y across it from the centre line
+noperspective out vec2 vLinePos;
+flat out float vLength;
+
+vec4 clipPosition(uint index) {
+    int base = int(index) * 3;
+    vec3 p = vec3(texelFetch(u_positions, base).r, texelFetch(u_positions, base + 1).r, texelFetch(u_positions, base + 2).r);
+    return u_mvp * vec4(p, 1.0);
+}
+
+void main() {
+    vec4 a = clipPosition(aEdge.x);
+    vec4 b = clipPosition(aEdge.y);
+
+    // Clip against the near plane (z + w >= 0) before the perspective divide
+    float da = a.z + a.w, db = b.z + b.w;
+    if (da < 0.0 && db < 0.0) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0); // Outside the clip volume, culled
+        vLinePos = vec2(0.0);
+        vLength = 0.0;
+        return;
+    }
+    if (da < 0.0) a = mix(a, b, da / (da - db));
+    else if (db < 0.0) b = mix(b, a, db / (db - da));
+
+    // Window coordinates (bottom-left origin) of both end points
+    vec2 sa = (a.xy / a.w * 0.5 + 0.5) * u_screenSize;
+    vec2 sb = (b.xy / b.w * 0.5 + 0.5) * u_screenSize;
+    vec2 d = sb - sa;
+    float len = length(d);
+    vec2 dir = len > 1e-4 ? d / len : vec2(1.0, 0.0);
+    vec2 normal = vec2(-dir.y, dir.x);
+
+    // Pad by one pixel on every side so the coverage ramp fits in the quad
+    float halfExtent = 0.5 * u_lineWidth + 1.0;
+    float along = (gl_VertexID & 2) != 0 ? len + 1.0 : -1.0;
+    float across = (gl_VertexID & 1) != 0 ? halfExtent : -halfExtent;
+    vec2 pos = sa + dir * along + normal * across;
+
+    gl_Position = vec4(pos / u_screenSize * 2.0 - 1.0, 0.0, 1.0);
+    vLinePos = vec2(along, across);
+    vLength = len;
+}
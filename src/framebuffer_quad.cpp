@@ -0,0 +1,58 @@
+#include <glad/glad.h>
+
+#include "framebuffer_quad.hpp"
+
+void FramebufferQuad::init() {
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    // Core profile needs a bound vertex array even without attributes
+    glGenVertexArrays(1, &VAO);
+}
+
+size_t FramebufferQuad::upload(const TileFramebuffer& framebuffer) {
+    const int width = framebuffer.width(), height = framebuffer.height();
+    if (width == 0 || height == 0) return 0;
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (width != textureWidth || height != textureHeight) {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, framebuffer.pixels());
+        textureWidth = width;
+        textureHeight = height;
+    } else {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, framebuffer.pixels());
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return static_cast<size_t>(width) * height * 4;
+}
+
+void FramebufferQuad::draw(Shader* shader) {
+    if (textureWidth == 0 || textureHeight == 0) return;
+    shader->activate();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    // Pixels are premultiplied by coverage
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void FramebufferQuad::destroy() {
+    if (texture) glDeleteTextures(1, &texture);
+    if (VAO) glDeleteVertexArrays(1, &VAO);
+    texture = VAO = 0;
+    textureWidth = textureHeight = 0;
+}
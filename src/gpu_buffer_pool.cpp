@@ -0,0 +1,116 @@
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+#include "gpu_buffer_pool.hpp"
+#include "log.hpp"
+
+bool GpuBufferPool::init(size_t initialPoints, StreamBuffer::Mode mode) {
+    destroy();
+    if (!pointStream.init(sizeof(WuVertex), initialPoints, mode)) {
+        std::cerr << "Failed to create the shared point stream" << std::endl;
+        return false;
+    }
+    glGenVertexArrays(1, &pointVAO);
+    bindPointAttributes();
+    return true;
+}
+
+// Point pointVAO's attributes at the current stream buffer (again after it was reallocated)
+void GpuBufferPool::bindPointAttributes() {
+    glBindVertexArray(pointVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, pointStream.buffer());
+    // Position attribute (vec2)
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(WuVertex), (void*)offsetof(WuVertex, position));
+    glEnableVertexAttribArray(0);
+    // Color attribute (vec4)
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(WuVertex), (void*)offsetof(WuVertex, color));
+    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    pointVAOBuffer = pointStream.buffer();
+}
+
+void GpuBufferPool::destroy() {
+    for (const auto& entry : staticSizes) glDeleteBuffers(1, &entry.first);
+    staticSizes.clear();
+    staticBytes = 0;
+    if (pointVAO) glDeleteVertexArrays(1, &pointVAO);
+    pointVAO = pointVAOBuffer = 0;
+    pointStream.destroy();
+    framePointCount = lastFramePoints = peakPoints = 0;
+    frameWait = lastFrameWaitMs = 0.0;
+    framesSincePeakReset = 0;
+}
+
+unsigned int GpuBufferPool::createStatic(unsigned int target, const void* data, size_t bytes) {
+    unsigned int buffer = 0;
+    glGenBuffers(1, &buffer);
+    if (!buffer) {
+        std::cerr << "Failed to create a static buffer of " << bytes << " bytes" << std::endl;
+        return 0;
+    }
+    glBindBuffer(target, buffer);
+    glBufferData(target, static_cast<GLsizeiptr>(bytes), data, GL_STATIC_DRAW);
+    staticSizes[buffer] = bytes;
+    staticBytes += bytes;
+    return buffer;
+}
+
+void GpuBufferPool::releaseStatic(unsigned int& buffer) {
+    auto it = staticSizes.find(buffer);
+    if (it != staticSizes.end()) {
+        staticBytes -= it->second;
+        staticSizes.erase(it);
+        glDeleteBuffers(1, &buffer);
+    }
+    buffer = 0;
+}
+
+GpuBufferPool::Range GpuBufferPool::streamPoints(const WuVertex* data, size_t count) {
+    Range range;
+    if (count == 0) return range;
+    range.first = pointStream.upload(data, count);
+    range.count = count;
+    if (pointStream.buffer() != pointVAOBuffer) bindPointAttributes();
+    framePointCount += count;
+    frameWait += pointStream.lastUpload().waitMs;
+    return range;
+}
+
+void GpuBufferPool::drawPoints(const Range& range) {
+    if (range.count == 0) return;
+    glBindVertexArray(pointVAO);
+    glDrawArrays(GL_POINTS, static_cast<GLint>(range.first), static_cast<GLsizei>(range.count));
+    glBindVertexArray(0);
+}
+
+void GpuBufferPool::endFrame() {
+    pointStream.fence();
+    lastFramePoints = framePointCount;
+    lastFrameWaitMs = frameWait;
+    framePointCount = 0;
+    frameWait = 0.0;
+
+    // Give memory back once a whole window of frames stayed far below capacity
+    // (e.g. after zooming out of a dense view or closing a large mesh)
+    peakPoints = std::max(peakPoints, lastFramePoints);
+    if (++framesSincePeakReset < kShrinkFrames) return;
+    const size_t target = std::max<size_t>(peakPoints + peakPoints / 2, 1 << 14);
+    if (target * 4 <= pointStream.regionCapacity()) {
+        LOG_INFO("Shrinking point stream regions from %zu to %zu points", pointStream.regionCapacity(), target);
+        pointStream.resize(target);
+        bindPointAttributes();
+    }
+    peakPoints = 0;
+    framesSincePeakReset = 0;
+}
+
+GpuBufferPool::MemoryStats GpuBufferPool::memory() const {
+    MemoryStats stats;
+    stats.streamBytes = pointStream.capacityBytes();
+    stats.staticBytes = staticBytes;
+    stats.staticBuffers = staticSizes.size();
+    return stats;
+}
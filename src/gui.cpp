@@ -1,5 +1,6 @@
 #include "gui.hpp"
 #include "half_edge.hpp"
+#include <thread>
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
@@ -20,7 +21,7 @@ void shutdownImGui() {
     ImGui::DestroyContext();
 }
 
-void renderGui(GuiState& state, Mesh& mesh, TransformState* transformState, ViewportRect& viewportRect) {
+void renderGui(GuiState& state, Mesh& mesh, TransformState* transformState, ViewportRect& viewportRect, RenderSettings& renderSettings, const GpuBufferPool& gpuPool) {
 
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -54,6 +55,56 @@ void renderGui(GuiState& state, Mesh& mesh, TransformState* transformState, View
     if (ImGui::RadioButton("XIAOLIN_WU", mesh.currentRenderMode == Mesh::RenderMode::XIAOLIN_WU)) {
         mesh.setRenderMode(Mesh::RenderMode::XIAOLIN_WU);
     }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("BRESENHAM", mesh.currentRenderMode == Mesh::RenderMode::BRESENHAM)) {
+        mesh.setRenderMode(Mesh::RenderMode::BRESENHAM);
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("DDA", mesh.currentRenderMode == Mesh::RenderMode::DDA)) {
+        mesh.setRenderMode(Mesh::RenderMode::DDA);
+    }
+    if (ImGui::RadioButton("GL LINES", mesh.currentRenderMode == Mesh::RenderMode::LINES)) {
+        mesh.setRenderMode(Mesh::RenderMode::LINES);
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("GL POINTS", mesh.currentRenderMode == Mesh::RenderMode::POINTS)) {
+        mesh.setRenderMode(Mesh::RenderMode::POINTS);
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("GPU WU", mesh.currentRenderMode == Mesh::RenderMode::GPU_WU)) {
+        mesh.setRenderMode(Mesh::RenderMode::GPU_WU);
+    }
+    bool uniqueEdges = mesh.wuEdgeSource == Mesh::UNIQUE_EDGES;
+    if (ImGui::Checkbox("Unique edges", &uniqueEdges)) {
+        mesh.wuEdgeSource = uniqueEdges ? Mesh::UNIQUE_EDGES : Mesh::FACE_POLYGONS;
+    }
+    if (ImGui::RadioButton("GL points", renderSettings.wuBackend == RenderSettings::WU_POINTS)) {
+        renderSettings.wuBackend = RenderSettings::WU_POINTS;
+    }
+    ImGui::SameLine();
+    if (ImGui::RadioButton("Tile framebuffer", renderSettings.wuBackend == RenderSettings::WU_FRAMEBUFFER)) {
+        renderSettings.wuBackend = RenderSettings::WU_FRAMEBUFFER;
+    }
+    int rasterThreads = static_cast<int>(renderSettings.rasterThreads);
+    if (ImGui::SliderInt("Raster threads", &rasterThreads, 0, static_cast<int>(std::thread::hardware_concurrency()), rasterThreads == 0 ? "all" : "%d")) {
+        renderSettings.rasterThreads = static_cast<unsigned>(rasterThreads);
+    }
+    if (mesh.lineRasterizer()) {
+        ImGui::Text("%.2f ms/frame, %u %s points", 1000.0f / ImGui::GetIO().Framerate, mesh.wu_point_count, mesh.lineRasterizer()->name());
+        if (mesh.currentRenderMode != Mesh::XIAOLIN_WU || renderSettings.wuBackend == RenderSettings::WU_POINTS) {
+            ImGui::Text("Upload %.2f MB/frame, wait %.3f ms (%s)", gpuPool.framePoints() * sizeof(WuVertex) / 1e6,
+                        gpuPool.frameWaitMs(), gpuPool.stream().modeName());
+            ImGui::Text("Stream points %zu..%zu of %zu per region", mesh.wuRange.first, mesh.wuRange.first + mesh.wuRange.count,
+                        gpuPool.stream().regionCapacity());
+        }
+    } else if (mesh.currentRenderMode == Mesh::RenderMode::GPU_WU && mesh.gpuLinesSupported) {
+        ImGui::Text("%.2f ms/frame, GPU expands %zu edges to antialiased quads", 1000.0f / ImGui::GetIO().Framerate, mesh.edge_indices.size());
+    } else {
+        ImGui::Text("%.2f ms/frame, GPU draws %zu edges", 1000.0f / ImGui::GetIO().Framerate, mesh.edge_indices.size());
+    }
+    const GpuBufferPool::MemoryStats gpuMemory = gpuPool.memory();
+    ImGui::Text("GPU memory %.2f MB: stream %.2f MB, %zu mesh buffers %.2f MB", gpuMemory.totalBytes() / 1e6,
+                gpuMemory.streamBytes / 1e6, gpuMemory.staticBuffers, gpuMemory.staticBytes / 1e6);
 
     ImGui::Separator();
     ImGui::Text("Viewport Rectangle");
@@ -1,186 +1,251 @@
-#include <unordered_map>
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include "../include/half_edge.hpp"
+#include "../include/radix_sort.hpp"
+#include "../include/thread_pool.hpp"
 #include "../include/utils.hpp"
 
-// Hash function for std::pair, used in unordered_map for edge lookup
-struct pair_hash {
-    template <class T1, class T2>
-    std::size_t operator() (const std::pair<T1,T2>& p) const {
-        return std::hash<T1>()(p.first) ^ std::hash<T2>()(p.second);
-    }
-};
+namespace {
 
+// Below this many items the parallel paths are not worth the hand-off
+const size_t kParallelThreshold = 32768;
 
-// Build the half-edge mesh structure from points and face indices
-void buildHalfEdgeMeshFromPointsAndFaces(
-    const std::vector<Point>& points,
-    const std::vector<std::vector<int>>& face_indices,
-    std::vector<Vertex>& vertices,
-    std::vector<HalfEdge>& halfedges,
-    std::vector<Face>& faces) {
-    // Copy points to vertices
-    vertices.clear();
-    for (const auto& p : points) {
-        vertices.push_back({p.x, p.y, p.z, nullptr});
+// Number of bits needed to store any index below count
+unsigned bitWidth(size_t count) {
+    unsigned bits = 1;
+    while (bits < 32 && (size_t(1) << bits) < count) ++bits;
+    return bits;
+}
+
+// Run fn(begin, end, chunk) over [0, count), on the pool when it pays off
+template <class F>
+size_t forRanges(ThreadPool* pool, size_t count, F&& fn) {
+    if (pool && pool->size() > 1 && count >= kParallelThreshold) {
+        pool->parallelFor(count, fn);
+        return std::min<size_t>(pool->size(), count);
     }
+    if (count > 0) fn(size_t(0), count, size_t(0));
+    return 1;
+}
 
-    // Count total half-edges needed
-    int hedge_count = 0;
-    for (const auto& inds : face_indices) hedge_count += inds.size();
-    halfedges.resize(hedge_count);
-    faces.resize(face_indices.size());
-
-    // Map from (start, end) vertex index to half-edge pointer
-    std::unordered_map<std::pair<int,int>, HalfEdge*, pair_hash> edge_map;
-    int hedge_idx = 0;
-    for (size_t f = 0; f < face_indices.size(); ++f) {
-        const auto& inds = face_indices[f];
-        int n = inds.size();
-        // Store indices of half-edges for this face
-        std::vector<int> hedge_indices;
-        for (int i = 0; i < n; ++i) {
-            int curr = inds[i];
-            int next = inds[(i+1)%n];
-            HalfEdge* he = &halfedges[hedge_idx];
-            he->origin = &vertices[curr];
-            he->face = &faces[f];
-            hedge_indices.push_back(hedge_idx);
-            edge_map[{curr, next}] = he;
-            hedge_idx++;
-        }
-        // Assign next pointers for this face
-        for (int i = 0; i < n; ++i) {
-            halfedges[hedge_indices[i]].next = &halfedges[hedge_indices[(i+1)%n]];
+} // namespace
+
+
+// Link twins by sorting half-edges on their undirected edge key
+HalfEdgeBuildReport linkTwinHalfEdges(HalfEdgeMesh& mesh, ThreadPool* pool) {
+    const size_t hedge_count = mesh.halfEdgeCount();
+    mesh.twin.assign(hedge_count, HE_INVALID);
+
+    // Pack (min vertex, max vertex) into one key; both directions of an edge share it
+    const unsigned bits = bitWidth(mesh.vertexCount());
+    std::vector<KeyIndex> keys(hedge_count);
+    forRanges(pool, hedge_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t he = begin; he < end; ++he) {
+            const uint64_t a = mesh.origin[he];
+            const uint64_t b = mesh.dest(static_cast<HEIndex>(he));
+            keys[he] = {a < b ? (a << bits) | b : (b << bits) | a, static_cast<HEIndex>(he)};
         }
-        // Assign one edge to the face
-        faces[f].edge = &halfedges[hedge_indices[0]];
-    }
+    });
+    // Stable, so within a key half-edges stay in ascending index order
+    radixSortPairs(keys, 2 * bits, pool);
+
+    // Each range handles the key groups that start inside it, so ranges
+    // write disjoint half-edges; reports are merged in range order.
+    const size_t maxChunks = pool ? pool->size() : 1;
+    std::vector<HalfEdgeBuildReport> reports(maxChunks);
+    const size_t chunks = forRanges(pool, hedge_count, [&](size_t begin, size_t end, size_t c) {
+        HalfEdgeBuildReport& report = reports[c];
+        size_t i = begin;
+        while (i > 0 && i < end && keys[i].key == keys[i - 1].key) ++i;
+
+        // For each directed edge the last half-edge wins, as with a map keyed on
+        // (origin, dest) that is overwritten in build order
+        while (i < end) {
+            size_t j = i + 1;
+            while (j < hedge_count && keys[j].key == keys[i].key) ++j;
+
+            const HEIndex low = static_cast<HEIndex>(keys[i].key >> bits);
+            HEIndex forward = HE_INVALID, backward = HE_INVALID;
+            for (size_t k = i; k < j; ++k) {
+                const HEIndex he = keys[k].index;
+                if (mesh.origin[he] == low) forward = he;
+                else backward = he;
+            }
+            if (forward != HE_INVALID && mesh.origin[forward] == mesh.dest(forward)) {
+                // Degenerate loop edge (a, a) is its own reverse
+                mesh.twin[forward] = forward;
+            } else if (forward != HE_INVALID && backward != HE_INVALID) {
+                mesh.twin[forward] = backward;
+                mesh.twin[backward] = forward;
+            }
 
-    // Set twin pointers for each half-edge
-    for (const auto& kv : edge_map) {
-        auto key = kv.first;
-        auto it = edge_map.find({key.second, key.first});
-        if (it != edge_map.end()) {
-            kv.second->twin = it->second;
+            if (j - i > 2) {
+                if (report.nonManifoldSamples.size() < HalfEdgeBuildReport::kMaxSamples) {
+                    report.nonManifoldSamples.push_back({low, static_cast<HEIndex>(keys[i].key & ((uint64_t(1) << bits) - 1))});
+                }
+                ++report.nonManifoldEdges;
+            }
+            i = j;
+        }
+    });
+
+    HalfEdgeBuildReport report;
+    for (size_t c = 0; c < chunks; ++c) {
+        report.nonManifoldEdges += reports[c].nonManifoldEdges;
+        for (const auto& sample : reports[c].nonManifoldSamples) {
+            if (report.nonManifoldSamples.size() < HalfEdgeBuildReport::kMaxSamples) {
+                report.nonManifoldSamples.push_back(sample);
+            }
         }
     }
+    return report;
+}
+
 
-    // Assign one outgoing edge to each vertex (first found)
-    for (auto& he : halfedges) {
-        if (!he.origin->edge) {
-            he.origin->edge = &he;
+// Build the half-edge mesh structure from points and face indices
+HalfEdgeBuildReport buildHalfEdgeMeshFromPointsAndFaces(
+    const std::vector<Point>& points,
+    const FaceList& face_list,
+    HalfEdgeMesh& mesh,
+    ThreadPool* pool) {
+    const size_t hedge_count = face_list.indices.size();
+    const size_t face_count = face_list.size();
+    mesh.origin.resize(hedge_count);
+    mesh.next.resize(hedge_count);
+    mesh.face.resize(hedge_count);
+    mesh.faceEdge.resize(face_count);
+
+    // The CSR face offsets are the prefix sum of face sizes, so each face
+    // already knows where its half-edges start and faces fill independently
+    forRanges(pool, face_count, [&](size_t begin, size_t end, size_t) {
+        for (size_t f = begin; f < end; ++f) {
+            const int* inds = face_list.face(f);
+            const int n = face_list.faceSize(f);
+            const HEIndex first = static_cast<HEIndex>(face_list.offsets[f]);
+            for (int i = 0; i < n; ++i) {
+                const HEIndex he = first + i;
+                mesh.origin[he] = inds[i];
+                mesh.face[he] = static_cast<HEIndex>(f);
+                mesh.next[he] = first + (i + 1) % n;
+            }
+            // Assign one edge to the face
+            mesh.faceEdge[f] = first;
+        }
+    });
+    mesh.vertexEdge.assign(points.size(), HE_INVALID);
+
+    // Set twin links for each half-edge
+    HalfEdgeBuildReport report = linkTwinHalfEdges(mesh, pool);
+
+    // Assign one outgoing edge to each vertex: the lowest-numbered one, which
+    // is what a serial first-found scan picks
+    if (pool && pool->size() > 1 && hedge_count >= kParallelThreshold) {
+        const size_t vertex_count = points.size();
+        std::unique_ptr<std::atomic<HEIndex>[]> lowest(new std::atomic<HEIndex>[vertex_count]);
+        pool->parallelFor(vertex_count, [&](size_t begin, size_t end, size_t) {
+            for (size_t v = begin; v < end; ++v) lowest[v].store(HE_INVALID, std::memory_order_relaxed);
+        });
+        pool->parallelFor(hedge_count, [&](size_t begin, size_t end, size_t) {
+            for (size_t he = begin; he < end; ++he) {
+                std::atomic<HEIndex>& slot = lowest[mesh.origin[he]];
+                HEIndex current = slot.load(std::memory_order_relaxed);
+                while (he < current && !slot.compare_exchange_weak(current, static_cast<HEIndex>(he), std::memory_order_relaxed)) {
+                }
+            }
+        });
+        pool->parallelFor(vertex_count, [&](size_t begin, size_t end, size_t) {
+            for (size_t v = begin; v < end; ++v) mesh.vertexEdge[v] = lowest[v].load(std::memory_order_relaxed);
+        });
+    } else {
+        for (HEIndex he = 0; he < hedge_count; ++he) {
+            if (mesh.vertexEdge[mesh.origin[he]] == HE_INVALID) {
+                mesh.vertexEdge[mesh.origin[he]] = he;
+            }
         }
     }
+    return report;
 }
 
 
 // Given a face, return all adjacent faces (sharing an edge)
-std::vector<Face*> getAdjacentFacesOfFace(Face* f) {
-    std::vector<Face*> adj;
-    if (!f || !f->edge) return adj;
-    HalfEdge* start = f->edge;
-    HalfEdge* e = start;
-    do {
-        // If the twin exists and is not the same face, add it
-        if (e->twin && e->twin->face && e->twin->face != f)
-            adj.push_back(e->twin->face);
-        e = e->next;
-    } while (e != start);
+std::vector<HEIndex> getAdjacentFacesOfFace(const HalfEdgeMesh& mesh, HEIndex f) {
+    std::vector<HEIndex> adj;
+    forEachAdjacentFaceOfFace(mesh, f, [&](HEIndex g) { adj.push_back(g); });
     return adj;
 }
 
 
 // Given an edge, return the two faces it borders (if any)
-std::vector<Face*> getAdjacentFacesOfEdge(HalfEdge* e) {
-    std::vector<Face*> adj;
-    if (e && e->face) adj.push_back(e->face);
-    if (e && e->twin && e->twin->face && e->twin->face != e->face) adj.push_back(e->twin->face);
+std::vector<HEIndex> getAdjacentFacesOfEdge(const HalfEdgeMesh& mesh, HEIndex e) {
+    std::vector<HEIndex> adj;
+    forEachFaceOfEdge(mesh, e, [&](HEIndex f) { adj.push_back(f); });
     return adj;
 }
 
 
 // Traverses all faces around a vertex, even if there are boundaries.
-std::vector<Face*> getFacesOfVertex(Vertex* v) {
-    std::vector<Face*> faces;
-    if (!v || !v->edge) return faces;
-
-    HalfEdge* start_he = v->edge;
-    
-    // --- Forward (CW) traversal ---
-    HalfEdge* current_he = start_he;
-    do {
-        if (current_he->face) {
-            faces.push_back(current_he->face);
-        }
-        current_he = current_he->twin ? current_he->twin->next : nullptr;
-    } while (current_he != nullptr && current_he != start_he);
-
-    // --- Backward (CCW) traversal for boundaries ---
-    if (current_he == nullptr) { // We hit a boundary, so traverse the other way
-        // To go "backward", find the previous edge in the face loop and take its twin.
-        HalfEdge* pred = start_he;
-        // Start the backward traversal from the start edge's predecessor
-        // Use a safe for loop to prevent infinite loops on malformed geometry
-        for (int i = 0; i < 256; ++i) { 
-            if (pred->next == start_he) break;
-            pred = pred->next;
-            if (i == 255) return faces; // Safety break
-        }
-        current_he = pred->twin;
-
-        while (current_he != nullptr) {
-            if (current_he->face) {
-                faces.push_back(current_he->face);
-            }
-            pred = current_he;
-            bool found_pred = false;
-            // Use a safe for loop to find the next predecessor
-            for(int i=0; i < 256; ++i) {
-                if (pred->next == current_he) {
-                    found_pred = true;
-                    break;
-                }
-                pred = pred->next;
-            }
-            // If the loop structure is broken, stop to prevent a crash
-            if (!found_pred) break;
-            current_he = pred->twin;
-        }
-    }
+std::vector<HEIndex> getFacesOfVertex(const HalfEdgeMesh& mesh, HEIndex v) {
+    std::vector<HEIndex> faces;
+    forEachFaceOfVertex(mesh, v, [&](HEIndex f) { faces.push_back(f); });
     return faces;
 }
 
 
 // Traverses all outgoing edges from a vertex, even if there are boundaries.
-std::vector<HalfEdge*> getEdgesOfVertex(Vertex* v) {
-    std::vector<HalfEdge*> incident_edges;
-    if (!v || !v->edge) return incident_edges;
-
-    // First, get all faces that touch this vertex using the robust function.
-    std::vector<Face*> faces = getFacesOfVertex(v);
-
-    // Iterate through all the edges of those faces.
-    for (Face* f : faces) {
-        if (!f || !f->edge) continue;
-        HalfEdge* start_he = f->edge;
-        HalfEdge* current_he = start_he;
-        do {
-            // An edge is incident to v if it starts at v (outgoing)
-            // or if it ends at v (incoming). The end of `current_he` is the start of `current_he->next`.
-            if (current_he->origin == v || current_he->next->origin == v) {
-                incident_edges.push_back(current_he);
-            }
-            current_he = current_he->next;
-        } while (current_he != start_he);
-    }
+std::vector<HEIndex> getEdgesOfVertex(const HalfEdgeMesh& mesh, HEIndex v) {
+    std::vector<HEIndex> incident_edges;
+    forEachEdgeOfVertex(mesh, v, [&](HEIndex he) { incident_edges.push_back(he); });
 
-    // The above loop can add the same edge multiple times if it's an interior edge
-    // shared by two faces in the list. We must remove duplicates.
+    // An interior edge can be reached from two faces in the list, so remove duplicates.
     std::sort(incident_edges.begin(), incident_edges.end());
     incident_edges.erase(std::unique(incident_edges.begin(), incident_edges.end()), incident_edges.end());
 
     return incident_edges;
 }
+
+
+namespace {
+
+// Writes visited indices into out while there is room, counting all of them
+struct SpanWriter {
+    HEIndex* out;
+    size_t capacity;
+    size_t count = 0;
+
+    void operator()(HEIndex i) {
+        if (count < capacity) out[count] = i;
+        ++count;
+    }
+};
+
+} // namespace
+
+size_t getAdjacentFacesOfFace(const HalfEdgeMesh& mesh, HEIndex f, HEIndex* out, size_t capacity) {
+    SpanWriter writer{out, capacity};
+    forEachAdjacentFaceOfFace(mesh, f, [&](HEIndex g) { writer(g); });
+    return writer.count;
+}
+
+size_t getAdjacentFacesOfEdge(const HalfEdgeMesh& mesh, HEIndex e, HEIndex* out, size_t capacity) {
+    SpanWriter writer{out, capacity};
+    forEachFaceOfEdge(mesh, e, [&](HEIndex f) { writer(f); });
+    return writer.count;
+}
+
+size_t getFacesOfVertex(const HalfEdgeMesh& mesh, HEIndex v, HEIndex* out, size_t capacity) {
+    SpanWriter writer{out, capacity};
+    forEachFaceOfVertex(mesh, v, [&](HEIndex f) { writer(f); });
+    return writer.count;
+}
+
+size_t getEdgesOfVertex(const HalfEdgeMesh& mesh, HEIndex v, HEIndex* out, size_t capacity) {
+    SpanWriter writer{out, capacity};
+    forEachEdgeOfVertex(mesh, v, [&](HEIndex he) { writer(he); });
+    // Duplicates can only be removed once everything fits; otherwise report the upper bound
+    if (writer.count > capacity) return writer.count;
+    std::sort(out, out + writer.count);
+    return static_cast<size_t>(std::unique(out, out + writer.count) - out);
+}
@@ -0,0 +1,163 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "headless.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Same background and line color as the viewer
+const glm::vec3 kBackground(0.1f, 0.1f, 0.1f);
+const glm::vec4 kLineColor(1.0f, 0.5f, 0.5f, 1.0f);
+
+// Centre and camera distance that keep the bounding sphere of all meshes
+// inside the viewport rectangle while the scene turns
+struct SceneFit {
+    glm::vec3 center;
+    float radius;
+    float distance;
+};
+
+SceneFit fitScene(const std::vector<Mesh>& meshes, float fovy, int width, int height, const ViewportRect& viewport) {
+    bool any = false;
+    Point lo{0, 0, 0}, hi{0, 0, 0};
+    for (const Mesh& mesh : meshes) {
+        for (const Point& p : mesh.points) {
+            if (!any) lo = hi = p;
+            any = true;
+            lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+            hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+        }
+    }
+    const glm::vec3 extent(hi.x - lo.x, hi.y - lo.y, hi.z - lo.z);
+    const float radius = std::max(0.5f * std::sqrt(extent.x * extent.x + extent.y * extent.y + extent.z * extent.z), 1e-6f);
+    // Half-angle of the cone through the viewport rectangle along its narrower axis
+    const float tanHalf = std::tan(0.5f * fovy);
+    const float shareX = std::max(0.1f, float(viewport.x_max - viewport.x_min) / width);
+    const float shareY = std::max(0.1f, float(viewport.y_max - viewport.y_min) / height);
+    const float halfAngle = std::atan(tanHalf * std::min(shareX * float(width) / height, shareY));
+    return {glm::vec3(0.5f * (lo.x + hi.x), 0.5f * (lo.y + hi.y), 0.5f * (lo.z + hi.z)), radius, radius / std::sin(halfAngle)};
+}
+
+} // namespace
+
+bool writePPM(const std::string& path, const TileFramebuffer& framebuffer, const glm::vec3& background) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "Failed to open " << path << " for writing" << std::endl;
+        return false;
+    }
+    out << "P6\n" << framebuffer.width() << " " << framebuffer.height() << "\n255\n";
+    const uint8_t bg[3] = {static_cast<uint8_t>(background.r * 255.0f + 0.5f), static_cast<uint8_t>(background.g * 255.0f + 0.5f),
+                           static_cast<uint8_t>(background.b * 255.0f + 0.5f)};
+    std::vector<uint8_t> row(static_cast<size_t>(framebuffer.width()) * 3);
+    const uint8_t* src = framebuffer.pixels();
+    for (int y = 0; y < framebuffer.height(); ++y) {
+        for (int x = 0; x < framebuffer.width(); ++x, src += 4) {
+            // Premultiplied "over": color + background * (1 - alpha)
+            for (int c = 0; c < 3; ++c) row[x * 3 + c] = static_cast<uint8_t>(src[c] + (bg[c] * (255 - src[3]) + 127) / 255);
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+    if (!out) {
+        std::cerr << "Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+uint64_t framebufferChecksum(const TileFramebuffer& framebuffer, uint64_t seed) {
+    const uint8_t* p = framebuffer.pixels();
+    const size_t bytes = static_cast<size_t>(framebuffer.width()) * framebuffer.height() * 4;
+    for (size_t i = 0; i < bytes; ++i) seed = (seed ^ p[i]) * 1099511628211ull;
+    return seed;
+}
+
+bool runHeadless(const std::vector<std::string>& filenames, const MeshLoadOptions& loadOptions, const HeadlessOptions& options) {
+    std::vector<Mesh> meshes;
+    for (const std::string& filename : filenames) {
+        Mesh mesh(filename);
+        if (!mesh.load(filename, loadOptions)) {
+            std::cerr << "Failed to load mesh: " << filename << std::endl;
+            return false;
+        }
+        mesh.wuEdgeSource = options.edgeSource;
+        meshes.push_back(std::move(mesh));
+    }
+    if (meshes.empty() || options.width <= 0 || options.height <= 0 || options.frames <= 0) {
+        std::cerr << "Nothing to render" << std::endl;
+        return false;
+    }
+    if (!options.outputDir.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(options.outputDir, ec);
+        if (ec) {
+            std::cerr << "Failed to create " << options.outputDir << ": " << ec.message() << std::endl;
+            return false;
+        }
+    }
+
+    const unsigned threads = ThreadPool::resolveThreadCount(options.rasterThreads);
+    std::unique_ptr<ThreadPool> pool(threads > 1 ? new ThreadPool(threads) : nullptr);
+    for (Mesh& mesh : meshes) mesh.rasterPool = pool.get();
+
+    TileFramebuffer framebuffer;
+    framebuffer.resize(options.width, options.height);
+    // The viewer's 100 px margin, shrunk to a tenth of the short side for small images
+    const int margin = std::min(100, std::min(options.width, options.height) / 10);
+    const ViewportRect viewport = {margin, margin, options.width - margin, options.height - margin};
+    // The viewer's field of view; the turntable spins about the scene's centre
+    const TransformState state;
+    const SceneFit fit = fitScene(meshes, glm::radians(state.pov), options.width, options.height, viewport);
+    // Depth range around the bounding sphere instead of the viewer's fixed 0.1-100, which
+    // would far-clip (and blank) large scenes; the sphere stays put while the scene turns
+    const float zNear = std::max(fit.distance - 1.05f * fit.radius, 1e-3f);
+    const float zFar = fit.distance + 1.05f * fit.radius;
+    const glm::mat4 projection = glm::perspective(glm::radians(state.pov), float(options.width) / float(options.height), zNear, zFar);
+    const glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -fit.distance));
+
+    std::printf("Headless: %zu mesh(es), %dx%d, %d frames, %u raster thread(s)\n", meshes.size(), options.width,
+                options.height, options.frames, threads);
+    std::vector<double> frameMs;
+    uint64_t checksum = 14695981039346656037ull;
+    bool ok = true;
+    for (int frame = 0; frame < options.frames; ++frame) {
+        const float angle = 6.2831853f * frame / options.frames;
+        const glm::mat4 model = glm::translate(glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f)), -fit.center);
+
+        const auto start = Clock::now();
+        framebuffer.clear(pool.get());
+        for (Mesh& mesh : meshes) {
+            mesh.drawToFramebuffer(model * mesh.objectTransform, view, projection, options.width, options.height, kLineColor,
+                                   viewport, framebuffer);
+        }
+        frameMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        checksum = framebufferChecksum(framebuffer, checksum);
+
+        const bool save = !options.outputDir.empty() && frame % std::max(options.saveEvery, 1) == 0;
+        if (save) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "frame_%04d.ppm", frame);
+            ok = writePPM((std::filesystem::path(options.outputDir) / name).string(), framebuffer, kBackground) && ok;
+        }
+        std::printf("frame %4d: %8.3f ms%s\n", frame, frameMs.back(), save ? " (saved)" : "");
+    }
+
+    std::vector<double> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (double ms : frameMs) total += ms;
+    std::printf("Rendered %d frames: mean %.3f ms, min %.3f ms, median %.3f ms, max %.3f ms (%.1f fps)\n", options.frames,
+                total / options.frames, sorted.front(), sorted[sorted.size() / 2], sorted.back(), 1000.0 * options.frames / total);
+    std::printf("Checksum %016llx\n", static_cast<unsigned long long>(checksum));
+    return ok;
+}
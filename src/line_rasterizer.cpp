@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "line_rasterizer.hpp"
+#include "xiaolin_wu.hpp"
+
+namespace {
+
+// Same cut-off the Wu path always used: fainter pixels are not drawn
+const double kMinWuIntensity = 0.05;
+
+class WuLineRasterizer : public LineRasterizer {
+public:
+    const char* name() const override { return "Wu"; }
+
+    size_t pixelBound(glm::vec2 p0, glm::vec2 p1) const override { return wuLinePixelCount(p0, p1); }
+
+    WuVertex* rasterize(glm::vec2 p0, glm::vec2 p1, const glm::vec3& rgb, WuVertex* out) const override {
+        rasterizeWuLine(p0, p1, [&](int x, int y, double intensity) {
+            if (intensity > kMinWuIntensity) {
+                out->position = glm::vec2(x, y);
+                out->color = glm::vec4(rgb.r, rgb.g, rgb.b, intensity);
+                ++out;
+            }
+        });
+        return out;
+    }
+};
+
+class BresenhamLineRasterizer : public LineRasterizer {
+public:
+    const char* name() const override { return "Bresenham"; }
+
+    size_t pixelBound(glm::vec2 p0, glm::vec2 p1) const override {
+        const long dx = std::labs(std::lround(p1.x) - std::lround(p0.x));
+        const long dy = std::labs(std::lround(p1.y) - std::lround(p0.y));
+        return static_cast<size_t>(std::max(dx, dy)) + 1;
+    }
+
+    WuVertex* rasterize(glm::vec2 p0, glm::vec2 p1, const glm::vec3& rgb, WuVertex* out) const override {
+        const glm::vec4 color(rgb, 1.0f);
+        int x = static_cast<int>(std::lround(p0.x)), y = static_cast<int>(std::lround(p0.y));
+        const int x1 = static_cast<int>(std::lround(p1.x)), y1 = static_cast<int>(std::lround(p1.y));
+        const int dx = std::abs(x1 - x), dy = -std::abs(y1 - y);
+        const int sx = x < x1 ? 1 : -1, sy = y < y1 ? 1 : -1;
+        // All octants with one error term: err = dx + dy tracks the distance to the ideal line
+        int err = dx + dy;
+        for (;;) {
+            out->position = glm::vec2(x, y);
+            out->color = color;
+            ++out;
+            if (x == x1 && y == y1) break;
+            const int e2 = 2 * err;
+            if (e2 >= dy) {
+                err += dy;
+                x += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                y += sy;
+            }
+        }
+        return out;
+    }
+};
+
+class DDALineRasterizer : public LineRasterizer {
+public:
+    const char* name() const override { return "DDA"; }
+
+    size_t pixelBound(glm::vec2 p0, glm::vec2 p1) const override { return steps(p0, p1) + 1; }
+
+    WuVertex* rasterize(glm::vec2 p0, glm::vec2 p1, const glm::vec3& rgb, WuVertex* out) const override {
+        const glm::vec4 color(rgb, 1.0f);
+        const int n = steps(p0, p1);
+        const glm::vec2 increment = n > 0 ? (p1 - p0) / static_cast<float>(n) : glm::vec2(0.0f);
+        glm::vec2 p = p0;
+        for (int i = 0; i <= n; ++i) {
+            out->position = glm::vec2(std::round(p.x), std::round(p.y));
+            out->color = color;
+            ++out;
+            p += increment;
+        }
+        return out;
+    }
+
+private:
+    static int steps(glm::vec2 p0, glm::vec2 p1) {
+        return static_cast<int>(std::ceil(std::max(std::abs(p1.x - p0.x), std::abs(p1.y - p0.y))));
+    }
+};
+
+} // namespace
+
+const LineRasterizer& wuLineRasterizer() {
+    static const WuLineRasterizer instance;
+    return instance;
+}
+
+const LineRasterizer& bresenhamLineRasterizer() {
+    static const BresenhamLineRasterizer instance;
+    return instance;
+}
+
+const LineRasterizer& ddaLineRasterizer() {
+    static const DDALineRasterizer instance;
+    return instance;
+}
@@ -0,0 +1,185 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "log.hpp"
+
+namespace {
+
+const size_t kRingSize = 4096;    // Slots, power of two
+const size_t kMessageBytes = 240; // Longer messages are truncated
+
+struct LogRecord {
+    std::atomic<size_t> sequence{0};
+    int64_t micros = 0;
+    LogLevel level = LogLevel::Info;
+    char text[kMessageBytes];
+};
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        default: return "?";
+    }
+}
+
+// Bounded multi-producer/single-consumer queue. Each slot carries a
+// sequence number: a producer claims position p with a CAS on head and
+// publishes it by setting the slot's sequence to p + 1; the consumer
+// frees it for the next lap by setting it to p + kRingSize.
+class Logger {
+public:
+    Logger() : records(new LogRecord[kRingSize]), start(std::chrono::steady_clock::now()) {
+        for (size_t i = 0; i < kRingSize; ++i) records[i].sequence.store(i, std::memory_order_relaxed);
+        writer = std::thread([this] { drainLoop(); });
+    }
+
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+    }
+
+    std::atomic<size_t> dropped{0}; // Total since start
+
+    void push(LogLevel messageLevel, const char* format, va_list args) {
+        size_t pos = head.load(std::memory_order_relaxed);
+        LogRecord* record;
+        for (;;) {
+            record = &records[pos & (kRingSize - 1)];
+            const size_t seq = record->sequence.load(std::memory_order_acquire);
+            if (seq == pos) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (seq < pos) {
+                dropped.fetch_add(1, std::memory_order_relaxed); // Full: never block the caller
+                return;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
+        }
+        record->micros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        record->level = messageLevel;
+        std::vsnprintf(record->text, kMessageBytes, format, args);
+        record->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    void flush() {
+        const size_t target = head.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(mutex);
+        flushRequested = true;
+        wake.notify_one();
+        drained.wait(lock, [&] { return tail >= target || stopping; });
+    }
+
+private:
+    std::unique_ptr<LogRecord[]> records;
+    std::chrono::steady_clock::time_point start;
+    alignas(64) std::atomic<size_t> head{0};
+    size_t tail = 0; // Only the writer thread advances it (under mutex for flush())
+    size_t reportedDrops = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable drained;
+    bool stopping = false;
+    bool flushRequested = false;
+    std::thread writer;
+
+    // Write every published record; returns false if there was none
+    bool drainOnce() {
+        bool any = false;
+        for (;;) {
+            LogRecord& record = records[tail & (kRingSize - 1)];
+            if (record.sequence.load(std::memory_order_acquire) != tail + 1) break;
+            std::fprintf(stderr, "[%10.3f] [%s] %s\n", record.micros * 1e-3, levelName(record.level), record.text);
+            record.sequence.store(tail + kRingSize, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++tail;
+            }
+            any = true;
+        }
+        const size_t lost = dropped.load(std::memory_order_relaxed);
+        if (lost > reportedDrops) {
+            std::fprintf(stderr, "[log] %zu messages dropped (ring buffer full)\n", lost - reportedDrops);
+            reportedDrops = lost;
+            any = true;
+        }
+        if (any) std::fflush(stderr);
+        return any;
+    }
+
+    void drainLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            // Producers never signal; poll a few times a second unless flushing
+            wake.wait_for(lock, std::chrono::milliseconds(20), [&] { return stopping || flushRequested; });
+            const bool finish = stopping;
+            flushRequested = false;
+            lock.unlock();
+            drainOnce();
+            lock.lock();
+            drained.notify_all();
+            if (finish) break;
+        }
+    }
+};
+
+Logger& logger() {
+    static Logger instance;
+    return instance;
+}
+
+} // namespace
+
+std::atomic<uint8_t> g_logLevel{static_cast<uint8_t>(LogLevel::Info)};
+
+void setLogLevel(LogLevel level) {
+    g_logLevel.store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+LogLevel logLevel() {
+    return static_cast<LogLevel>(g_logLevel.load(std::memory_order_relaxed));
+}
+
+bool parseLogLevel(const std::string& name, LogLevel& level) {
+    static const std::pair<const char*, LogLevel> names[] = {
+        {"trace", LogLevel::Trace}, {"debug", LogLevel::Debug}, {"info", LogLevel::Info},
+        {"warn", LogLevel::Warn}, {"error", LogLevel::Error}, {"off", LogLevel::Off}};
+    for (const auto& entry : names) {
+        if (name == entry.first) {
+            level = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+void logWrite(LogLevel level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    logger().push(level, format, args);
+    va_end(args);
+}
+
+void logFlush() {
+    logger().flush();
+}
+
+size_t logDroppedCount() {
+    return logger().dropped.load(std::memory_order_relaxed);
+}
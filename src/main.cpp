@@ -9,6 +9,11 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <utility>
+#include <memory>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
 
 // Project Headers
 #include "gui.hpp"
@@ -17,6 +22,11 @@
 #include "input.hpp"
 #include "half_edge.hpp"
 #include "utils.hpp"
+#include "log.hpp"
+#include "thread_pool.hpp"
+#include "tile_framebuffer.hpp"
+#include "framebuffer_quad.hpp"
+#include "headless.hpp"
 
 TransformState transformState;
 int WIDTH = 1080, HEIGHT = 1080;
@@ -25,38 +35,145 @@ int WIDTH = 1080, HEIGHT = 1080;
 // Default: 100px margin from each window edge
 ViewportRect viewportRect = {100, 100, WIDTH - 100, HEIGHT - 100};
 
+// Rendering knobs, editable from the GUI
+RenderSettings renderSettings;
+
 
 // Helper to load a mesh from file and add to vectors
-void loadMeshObject(const std::string& filename, std::vector<Mesh>& objects, std::vector<std::string>& object_names) {
+void loadMeshObject(const std::string& filename, std::vector<Mesh>& objects, std::vector<std::string>& object_names, const MeshLoadOptions& loadOptions, Mesh::RenderMode renderMode, GpuBufferPool& gpuPool) {
     Mesh mesh(filename);
-    if (!mesh.loadFromOBJ(filename)) {
+    if (!mesh.load(filename, loadOptions)) {
         std::cerr << "Failed to load mesh: " << filename << std::endl;
         return;
     }
-    mesh.buildHalfEdge();
-    mesh.setupMesh();
-    mesh.setRenderMode(Mesh::XIAOLIN_WU);
-    objects.push_back(mesh);
+    mesh.setupMesh(gpuPool);
+    mesh.setRenderMode(renderMode);
+    objects.push_back(std::move(mesh));
     object_names.push_back(filename);
 }
 
+// Command line help, printed when no mesh is given or an option is invalid
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] <filename1> [filename2 ...]" << std::endl;
+    std::cerr << "  --threads N      OBJ parser and half-edge build threads (default 1, 0 = all cores)" << std::endl;
+    std::cerr << "  --rebuild-cache  Ignore cached meshes (<file>.cgmc) and rewrite them" << std::endl;
+    std::cerr << "  --no-cache       Neither read nor write mesh caches" << std::endl;
+    std::cerr << "  --raster-threads N  CPU line rasterization threads (default 1, 0 = all cores)" << std::endl;
+    std::cerr << "  --mode M         Initial render mode: wu (default), bresenham, dda, lines, points or gpu-wu" << std::endl;
+    std::cerr << "  --framebuffer    Rasterize into a CPU tile framebuffer instead of GL points" << std::endl;
+    std::cerr << "  --log-level L    trace, debug, info (default), warn, error or off" << std::endl;
+    std::cerr << "  --headless       No window or GL: render a turntable through the CPU framebuffer and print timings" << std::endl;
+    std::cerr << "  --frames N       Headless: camera path steps (default 60)" << std::endl;
+    std::cerr << "  --output DIR     Headless: write frames as DIR/frame_NNNN.ppm" << std::endl;
+    std::cerr << "  --save-every N   Headless: write every Nth frame only (default 1)" << std::endl;
+    std::cerr << "  --size WxH       Headless: image size (default 1080x1080)" << std::endl;
+}
+
+// Parses a whole decimal argument within [minValue, maxValue]
+bool parseNumber(const char* text, int minValue, int maxValue, int& value) {
+    const char* end = text + std::strlen(text);
+    int parsed = 0;
+    const auto result = std::from_chars(text, end, parsed);
+    if (result.ec != std::errc() || result.ptr != end || parsed < minValue || parsed > maxValue) return false;
+    value = parsed;
+    return true;
+}
+
+// WIDTHxHEIGHT, each side 1 to 16384 px
+bool parseSize(const char* text, int& width, int& height) {
+    const char* x = std::strchr(text, 'x');
+    if (!x) return false;
+    const std::string w(text, x);
+    return parseNumber(w.c_str(), 1, 16384, width) && parseNumber(x + 1, 1, 16384, height);
+}
+
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <filename1> [filename2 ...]" << std::endl;
+    // Command line: options start with "--", everything else is a mesh file
+    std::vector<std::string> filenames;
+    MeshLoadOptions loadOptions;
+    Mesh::RenderMode initialRenderMode = Mesh::XIAOLIN_WU;
+    bool headless = false;
+    HeadlessOptions headlessOptions;
+    // Rejects a malformed or out-of-range value with the usage text
+    auto invalid = [&](const std::string& option, const char* value) {
+        std::cerr << "Invalid value for " << option << ": " << value << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    };
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        int value = 0;
+        if (arg == "--threads" && i + 1 < argc) {
+            if (!parseNumber(argv[++i], 0, 1024, value)) return invalid(arg, argv[i]);
+            loadOptions.threads = static_cast<unsigned>(value);
+        } else if (arg == "--rebuild-cache") {
+            loadOptions.rebuildCache = true;
+        } else if (arg == "--no-cache") {
+            loadOptions.useCache = false;
+        } else if (arg == "--raster-threads" && i + 1 < argc) {
+            if (!parseNumber(argv[++i], 0, 1024, value)) return invalid(arg, argv[i]);
+            renderSettings.rasterThreads = static_cast<unsigned>(value);
+        } else if (arg == "--mode" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "wu") initialRenderMode = Mesh::XIAOLIN_WU;
+            else if (mode == "bresenham") initialRenderMode = Mesh::BRESENHAM;
+            else if (mode == "dda") initialRenderMode = Mesh::DDA;
+            else if (mode == "lines") initialRenderMode = Mesh::LINES;
+            else if (mode == "points") initialRenderMode = Mesh::POINTS;
+            else if (mode == "gpu-wu") initialRenderMode = Mesh::GPU_WU;
+            else {
+                std::cerr << "Unknown render mode: " << mode << std::endl;
+                return 1;
+            }
+        } else if (arg == "--framebuffer") {
+            renderSettings.wuBackend = RenderSettings::WU_FRAMEBUFFER;
+        } else if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            if (!parseNumber(argv[++i], 1, 1000000, headlessOptions.frames)) return invalid(arg, argv[i]);
+        } else if (arg == "--output" && i + 1 < argc) {
+            headlessOptions.outputDir = argv[++i];
+        } else if (arg == "--save-every" && i + 1 < argc) {
+            if (!parseNumber(argv[++i], 1, 1000000, headlessOptions.saveEvery)) return invalid(arg, argv[i]);
+        } else if (arg == "--size" && i + 1 < argc) {
+            if (!parseSize(argv[++i], headlessOptions.width, headlessOptions.height)) return invalid(arg, argv[i]);
+        } else if (arg == "--log-level" && i + 1 < argc) {
+            LogLevel level;
+            if (!parseLogLevel(argv[++i], level)) {
+                std::cerr << "Unknown log level: " << argv[i] << std::endl;
+                return 1;
+            }
+            setLogLevel(level);
+        } else {
+            filenames.push_back(arg);
+        }
+    }
+    if (filenames.empty()) {
+        printUsage(argv[0]);
         return 1;
     }
 
+    // No display needed: load, render and exit before GLFW is touched
+    if (headless) {
+        headlessOptions.rasterThreads = renderSettings.rasterThreads;
+        return runHeadless(filenames, loadOptions, headlessOptions) ? 0 : 1;
+    }
+
     GLFWwindow* window = setupGLFW();
     if (!window) return -1;
 
     // Previous transform state
     loadTransformState("state.json", transformState);
 
+    // GPU buffers of all meshes: one shared point stream plus exactly sized static buffers
+    GpuBufferPool gpuPool;
+    if (!gpuPool.init()) return -1;
+
     // Support multiple objects
     std::vector<Mesh> objects;
     std::vector<std::string> object_names;
-    for (int i = 1; i < argc; ++i) {
-        loadMeshObject(argv[i], objects, object_names);
+    for (const auto& filename : filenames) {
+        loadMeshObject(filename, objects, object_names, loadOptions, initialRenderMode, gpuPool);
     }
     if (objects.empty()) {
         std::cerr << "No valid meshes loaded. Exiting." << std::endl;
@@ -67,6 +184,17 @@ int main(int argc, char* argv[]) {
 
     wu_shader.setVec4("vertexColor", glm::vec4(1.0f, 0.5f, 0.5f, 1.0f));
 
+    // LINES and POINTS meshes are drawn by the GPU with the full MVP
+    Shader gl_line_shader("shaders/vertex_core.glsl", "shaders/fragment_core.glsl");
+    // GPU_WU meshes: edges expanded to antialiased quads in the shaders
+    Shader gpu_wu_shader("shaders/wu_line_gpu.vert", "shaders/wu_line_gpu.frag");
+
+    // Target of the WU_FRAMEBUFFER backend, shared by all meshes
+    Shader framebuffer_shader("shaders/framebuffer.vert", "shaders/framebuffer.frag");
+    TileFramebuffer framebuffer;
+    FramebufferQuad framebufferQuad;
+    framebufferQuad.init();
+
     GuiState guiState;
     guiState.selected_object = 0;
     guiState.object_names = object_names;
@@ -84,8 +212,18 @@ int main(int argc, char* argv[]) {
 
     setupImGui(window);
 
+    // Rebuilt whenever the GUI changes the raster thread count
+    std::unique_ptr<ThreadPool> rasterPool;
+    unsigned rasterPoolThreads = 1;
+
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
+
+        unsigned rasterThreads = ThreadPool::resolveThreadCount(renderSettings.rasterThreads);
+        if (rasterThreads != rasterPoolThreads) {
+            rasterPool.reset(rasterThreads > 1 ? new ThreadPool(rasterThreads) : nullptr);
+            rasterPoolThreads = rasterThreads;
+        }
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -101,6 +239,12 @@ int main(int argc, char* argv[]) {
         projection = glm::perspective(glm::radians(transformState.pov), aspect_ratio, 0.1f, 100.0f);
         view = glm::translate(glm::mat4(1.0f), glm::vec3(transformState.pan_offset.x, transformState.pan_offset.y, -3.0f / transformState.zoom_level));
 
+        const bool useFramebuffer = renderSettings.wuBackend == RenderSettings::WU_FRAMEBUFFER;
+        if (useFramebuffer) {
+            if (framebuffer.width() != width || framebuffer.height() != height) framebuffer.resize(width, height);
+            framebuffer.clear(rasterPool.get());
+        }
+
         // Handle transformation mode
         for (size_t i = 0; i < objects.size(); ++i) {
             // Always start with viewport transform
@@ -123,11 +267,25 @@ int main(int argc, char* argv[]) {
                 ? glm::vec4(0.2f, 1.0f, 0.2f, 1.0f) // green
                 : glm::vec4(1.0f, 0.5f, 0.5f, 1.0f); // default
             wu_shader.setVec4("vertexColor", objColor);
-            objects[i].drawWithXiaolinWu(&wu_shader, model, view, projection, width, height, objColor, viewportRect);
+            objects[i].rasterPool = rasterPool.get();
+            if (objects[i].currentRenderMode == Mesh::GPU_WU && objects[i].gpuLinesSupported) {
+                objects[i].drawGpuLines(&gpu_wu_shader, model, view, projection, width, height, objColor, viewportRect);
+            } else if (!objects[i].lineRasterizer()) {
+                objects[i].drawWithGL(&gl_line_shader, model, view, projection, height, objColor, viewportRect);
+            } else if (useFramebuffer && objects[i].currentRenderMode == Mesh::XIAOLIN_WU) {
+                objects[i].drawToFramebuffer(model, view, projection, width, height, objColor, viewportRect, framebuffer);
+            } else {
+                objects[i].drawRasterizedLines(&wu_shader, model, view, projection, width, height, objColor, viewportRect);
+            }
+        }
+        gpuPool.endFrame();
+        if (useFramebuffer) {
+            framebufferQuad.upload(framebuffer);
+            framebufferQuad.draw(&framebuffer_shader);
         }
 
         // Pass selected object to GUI (for future selection logic)
-        renderGui(guiState, objects[guiState.selected_object], &transformState, viewportRect);
+        renderGui(guiState, objects[guiState.selected_object], &transformState, viewportRect, renderSettings, gpuPool);
 
 
         // Draw viewport rectangle overlay using ImGui
@@ -144,7 +302,10 @@ int main(int argc, char* argv[]) {
         glfwSwapBuffers(window);
     }
 
-    // Cleanup
+    // Cleanup; meshes delete their GL objects while the context is still current
+    objects.clear();
+    framebufferQuad.destroy();
+    gpuPool.destroy();
     shutdownImGui();
     glfwDestroyWindow(window);
     glfwTerminate();
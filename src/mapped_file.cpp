@@ -0,0 +1,86 @@
+#include <fstream>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "mapped_file.hpp"
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fallbackBuffer = std::move(other.fallbackBuffer);
+        mappedData = other.isMapped ? other.mappedData : fallbackBuffer.data();
+        mappedSize = other.mappedSize;
+        opened = other.opened;
+        isMapped = other.isMapped;
+        other.mappedData = nullptr;
+        other.mappedSize = 0;
+        other.opened = false;
+        other.isMapped = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+#if !defined(_WIN32)
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    mappedSize = static_cast<size_t>(st.st_size);
+    if (mappedSize > 0) {
+        void* ptr = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (ptr == MAP_FAILED) {
+            ::close(fd);
+            mappedSize = 0;
+            return false;
+        }
+        // The whole file is scanned front to back
+        madvise(ptr, mappedSize, MADV_SEQUENTIAL);
+        mappedData = static_cast<const char*>(ptr);
+        isMapped = true;
+    }
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    mappedSize = static_cast<size_t>(file.tellg());
+    fallbackBuffer.resize(mappedSize);
+    file.seekg(0);
+    file.read(fallbackBuffer.data(), mappedSize);
+    mappedData = fallbackBuffer.data();
+#endif
+    opened = true;
+    return true;
+}
+
+void MappedFile::close() {
+#if !defined(_WIN32)
+    if (isMapped && mappedData) {
+        munmap(const_cast<char*>(mappedData), mappedSize);
+    }
+#endif
+    fallbackBuffer.clear();
+    mappedData = nullptr;
+    mappedSize = 0;
+    opened = false;
+    isMapped = false;
+}
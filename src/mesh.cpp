@@ -7,12 +7,25 @@
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 #include <cmath> // Ensure cmath is included for std::abs
+#include <chrono>
+#include <algorithm>
 
 #include "utils.hpp"
-#include "xiaolin_wu.hpp"
+#include "log.hpp"
+#include "obj_loader.hpp"
+#include "mesh_cache.hpp"
+#include "thread_pool.hpp"
 #include "weiler-atherton-clip.hpp"
+#include "segment_clip.hpp"
 #include "mesh.hpp"
 
+namespace {
+
+// Below this many segments the hand-off to the raster pool costs more than it saves
+const size_t kParallelRasterSegments = 256;
+
+} // namespace
+
 // Constructor
 Mesh::Mesh(const std::string& name_) : 
     name(name_),
@@ -21,6 +34,65 @@ Mesh::Mesh(const std::string& name_) :
 {
 }
 
+Mesh::Mesh(Mesh&& other) noexcept : Mesh(std::string()) {
+    *this = std::move(other);
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept {
+    if (this == &other) return *this;
+    destroy();
+    modelMatrix = other.modelMatrix;
+    shader = other.shader;
+    objectTransform = other.objectTransform;
+    name = std::move(other.name);
+    points = std::move(other.points);
+    face_indices = std::move(other.face_indices);
+    halfEdgeMesh = std::move(other.halfEdgeMesh);
+    oneRing = std::move(other.oneRing);
+    positionsSoA = std::move(other.positionsSoA);
+    projected = std::move(other.projected);
+    clippedFaces = std::move(other.clippedFaces);
+    edgeSegments = std::move(other.edgeSegments);
+    gpuPool = other.gpuPool;
+    wuRange = other.wuRange;
+    edge_indices = std::move(other.edge_indices);
+    wu_vertex_buffer = std::move(other.wu_vertex_buffer);
+    wu_chunk_buffers = std::move(other.wu_chunk_buffers);
+    rasterPool = other.rasterPool;
+    wu_point_count = other.wu_point_count;
+    gpuLinesSupported = other.gpuLinesSupported;
+    currentRenderMode = other.currentRenderMode;
+    wuEdgeSource = other.wuEdgeSource;
+    // The GL names now belong to this mesh only
+    VAO_gl = std::exchange(other.VAO_gl, 0u);
+    VBO_gl = std::exchange(other.VBO_gl, 0u);
+    EBO_gl = std::exchange(other.EBO_gl, 0u);
+    VAO_gpu = std::exchange(other.VAO_gpu, 0u);
+    positionTexture = std::exchange(other.positionTexture, 0u);
+    other.gpuPool = nullptr;
+    other.gpuLinesSupported = false;
+    other.wuRange = GpuBufferPool::Range();
+    return *this;
+}
+
+Mesh::~Mesh() {
+    destroy();
+}
+
+void Mesh::destroy() {
+    if (VAO_gpu) glDeleteVertexArrays(1, &VAO_gpu);
+    if (positionTexture) glDeleteTextures(1, &positionTexture);
+    if (VAO_gl) glDeleteVertexArrays(1, &VAO_gl);
+    // The static buffers came from the pool, which keeps their byte count
+    if (gpuPool) {
+        gpuPool->releaseStatic(VBO_gl);
+        gpuPool->releaseStatic(EBO_gl);
+    }
+    VAO_gl = VBO_gl = EBO_gl = VAO_gpu = positionTexture = 0;
+    gpuLinesSupported = false;
+    wuRange = GpuBufferPool::Range();
+}
+
 void Mesh::translate(const glm::vec3& trans) {
     modelMatrix = glm::translate(modelMatrix, trans);
 }
@@ -37,136 +109,307 @@ void Mesh::resetTransformations() {
     modelMatrix = glm::mat4(1.0f); 
 }
 
-bool Mesh::loadFromOBJ(const std::string& filename) {
-    points = loadOBJPoints(filename);
-    face_indices = loadOBJFaces(filename);
-    if(points.empty() || face_indices.empty()){
-        std::cerr << "Warning: Mesh loading resulted in empty points or faces." << std::endl;
+bool Mesh::load(const std::string& filename, const MeshLoadOptions& options) {
+    const std::string cachePath = meshCachePathFor(filename);
+    oneRing.clear();
+    if (options.useCache && !options.rebuildCache) {
+        auto start = std::chrono::steady_clock::now();
+        if (readMeshCache(cachePath, filename, *this)) {
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "Loaded " << points.size() << " vertices and " << face_indices.size() << " faces from cache "
+                      << cachePath << " in " << seconds * 1000.0 << " ms" << std::endl;
+            return true;
+        }
+    }
+
+    if (!loadFromOBJ(filename, options.threads)) {
         return false;
     }
-    std::cout << "Loaded " << points.size() << " vertices and " << face_indices.size() << " faces from " << filename << std::endl;
-    return true;
-}
+    buildHalfEdge(options.threads);
 
-void Mesh::buildHalfEdge() {
-    buildHalfEdgeMeshFromPointsAndFaces(points, face_indices, verticesHE, halfedgesHE, facesHE);
+    if (options.useCache) {
+        MeshCacheKey key;
+        if (!computeMeshCacheKey(filename, key) || !writeMeshCache(cachePath, key, *this)) {
+            std::cerr << "Warning: could not write mesh cache " << cachePath << std::endl;
+        }
+    }
+    return true;
 }
 
-void Mesh::setRenderMode(RenderMode newMode) {
-    currentRenderMode = newMode;
+bool Mesh::loadFromOBJ(const std::string& filename, unsigned threads) {
+    auto start = std::chrono::steady_clock::now();
+    ObjMeshData data;
+    if (!loadOBJ(filename, data, threads)) {
+        return false;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    points = std::move(data.points);
+    face_indices = std::move(data.faces);
+    if(points.empty() || face_indices.empty()){
+        std::cerr << "Warning: Mesh loading resulted in empty points or faces." << std::endl;
+        return false;
+    }
+    std::ifstream sizeProbe(filename, std::ios::binary | std::ios::ate);
+    double megabytes = static_cast<double>(sizeProbe.tellg()) / (1024.0 * 1024.0);
+    std::cout << "Loaded " << points.size() << " vertices and " << face_indices.size() << " faces from " << filename
+              << " in " << seconds * 1000.0 << " ms (" << megabytes / std::max(seconds, 1e-9) << " MB/s, "
+              << ThreadPool::resolveThreadCount(threads) << " threads)" << std::endl;
+    return true;
 }
 
-void Mesh::setupMesh() {
-    if (halfedgesHE.empty()) {
-        std::cerr << "Cannot setup mesh for rendering: half-edge structure not built." << std::endl;
-        return;
+void Mesh::buildHalfEdge(unsigned threads) {
+    HalfEdgeBuildReport report;
+    oneRing.clear();
+    threads = ThreadPool::resolveThreadCount(threads);
+    if (threads > 1) {
+        ThreadPool pool(threads);
+        report = buildHalfEdgeMeshFromPointsAndFaces(points, face_indices, halfEdgeMesh, &pool);
+    } else {
+        report = buildHalfEdgeMeshFromPointsAndFaces(points, face_indices, halfEdgeMesh);
     }
+    if (report.nonManifoldEdges > 0) {
+        std::cerr << "Warning: " << name << " has " << report.nonManifoldEdges
+                  << " non-manifold edges (more than two faces), e.g.";
+        for (const auto& e : report.nonManifoldSamples) {
+            std::cerr << " (" << e.first << ", " << e.second << ")";
+        }
+        std::cerr << std::endl;
+    }
+    buildEdgeList();
+}
 
+void Mesh::buildEdgeList() {
     edge_indices.clear();
 
     // Collect unique edges from Half-Edge structure
-    for (const auto& he : halfedgesHE) {
-        if (he.twin != nullptr && &he > he.twin) {
+    const HalfEdgeMesh& he = halfEdgeMesh;
+    for (HEIndex h = 0; h < he.halfEdgeCount(); ++h) {
+        if (he.twin[h] != HE_INVALID && h > he.twin[h]) {
             continue; // Skip twin to avoid duplicates
         }
-        unsigned int idx1 = he.origin - &verticesHE[0];
-        unsigned int idx2 = he.next->origin - &verticesHE[0];
-        edge_indices.push_back({idx1, idx2});
+        edge_indices.push_back({he.origin[h], he.dest(h)});
+    }
+}
+
+const VertexOneRing& Mesh::vertexOneRing(unsigned threads) {
+    if (oneRing.empty() && halfEdgeMesh.vertexCount() > 0) {
+        threads = ThreadPool::resolveThreadCount(threads);
+        if (threads > 1) {
+            ThreadPool pool(threads);
+            buildVertexOneRing(halfEdgeMesh, oneRing, &pool);
+        } else {
+            buildVertexOneRing(halfEdgeMesh, oneRing);
+        }
     }
+    return oneRing;
+}
 
-    glGenVertexArrays(1, &VAO_wu);
-    glGenBuffers(1, &VBO_wu);
+void Mesh::setRenderMode(RenderMode newMode) {
+    currentRenderMode = newMode;
+}
 
-    glBindVertexArray(VAO_wu);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO_wu);
+const LineRasterizer* Mesh::lineRasterizer() const {
+    switch (currentRenderMode) {
+        case XIAOLIN_WU: return &wuLineRasterizer();
+        case BRESENHAM: return &bresenhamLineRasterizer();
+        case DDA: return &ddaLineRasterizer();
+        default: return nullptr;
+    }
+}
+
+void Mesh::setupMesh(GpuBufferPool& pool) {
+    if (halfEdgeMesh.halfEdgeCount() == 0) {
+        std::cerr << "Cannot setup mesh for rendering: half-edge structure not built." << std::endl;
+        return;
+    }
 
-    // Allocating initial size (2 million vertices buffer)
-    wu_vbo_allocated_size = 2000000;
-    glBufferData(GL_ARRAY_BUFFER, wu_vbo_allocated_size * sizeof(WuVertex), nullptr, GL_DYNAMIC_DRAW);
+    // Set up again: drop the previous GL objects first
+    destroy();
+    // CPU rasterized modes stream into the pool's shared buffer, nothing to allocate here
+    gpuPool = &pool;
 
-    // Position attribute (vec2)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(WuVertex), (void*)offsetof(WuVertex, position));
+    // Hardware modes: static positions plus the unique edge list
+    glGenVertexArrays(1, &VAO_gl);
+    glBindVertexArray(VAO_gl);
+    VBO_gl = pool.createStatic(GL_ARRAY_BUFFER, points.data(), points.size() * sizeof(Point));
+    EBO_gl = pool.createStatic(GL_ELEMENT_ARRAY_BUFFER, edge_indices.data(), edge_indices.size() * sizeof(edge_indices[0]));
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Point), (void*)0);
     glEnableVertexAttribArray(0);
-    // Color attribute (vec4)
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(WuVertex), (void*)offsetof(WuVertex, color));
-    glEnableVertexAttribArray(1);
+    glBindVertexArray(0);
 
+    // GPU_WU reads the same two buffers: positions through a texture buffer, the
+    // edge list as one uvec2 attribute per instance
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    gpuLinesSupported = points.size() * 3 <= static_cast<size_t>(maxTexels);
+    if (!gpuLinesSupported) {
+        LOG_WARN("%s: %zu vertices exceed the texture buffer limit (%d texels), GPU Wu falls back to GL_LINES",
+                 name.c_str(), points.size(), maxTexels);
+        return;
+    }
+    glGenTextures(1, &positionTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, positionTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, VBO_gl);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    glGenVertexArrays(1, &VAO_gpu);
+    glBindVertexArray(VAO_gpu);
+    glBindBuffer(GL_ARRAY_BUFFER, EBO_gl);
+    glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(edge_indices[0]), (void*)0);
+    glEnableVertexAttribArray(0);
+    glVertexAttribDivisor(0, 1);
     glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void Mesh::drawWithXiaolinWu(Shader* shader,
-    const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, int screenWidth, int screenHeight, const glm::vec4& lineColor, const ViewportRect& viewport) {
+void Mesh::buildLineVertices(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection,
+    int screenWidth, int screenHeight, const glm::vec4& lineColor, const ViewportRect& viewport) {
     // Clear CPU buffer
     wu_vertex_buffer.clear();
 
     // 1. Project all mesh vertices to screen space
-    std::vector<glm::vec2> screenVerts = projectToScreenSpace(model, view, projection, screenWidth, screenHeight);
-
-    float xMin = static_cast<float>(viewport.x_min);
-    float yMin = static_cast<float>(viewport.y_min);
-    float xMax = static_cast<float>(viewport.x_max);
-    float yMax = static_cast<float>(viewport.y_max);
-    WA_Viewport vp{xMin, yMin, xMax, yMax};
-
-    // For each face, clip the polygon and draw the result
-    for (const auto& face : face_indices) {
-        // Build polygon in screen space
-        WA_Polygon poly;
-        for (int idx : face) {
-            glm::vec2 pt = screenVerts[idx];
-            poly.emplace_back(pt.x, pt.y);
-        }
-        // Clip polygon
-        WA_ClipResult clipResult = weiler_atherton_clip(poly, vp);
-        // Draw clipped polygon edges
-        const WA_Polygon& clipped = clipResult.clipped;
-        for (size_t i = 0; i < clipped.size(); ++i) {
-            const WA_Point& a = clipped[i];
-            const WA_Point& b = clipped[(i+1)%clipped.size()];
-            std::vector<Pixel> pixels = drawWuLine2D(glm::vec2(a.x, a.y), glm::vec2(b.x, b.y));
-            for (const auto& px : pixels) {
-                if (px.intensity > 0.05) {
-                    WuVertex v;
-                    v.position = glm::vec2(px.x, px.y);
-                    v.color = glm::vec4(lineColor.r, lineColor.g, lineColor.b, px.intensity);
-                    wu_vertex_buffer.push_back(v);
-                }
-            }
-        }
-        // Optionally: draw boundary segments as magenta
-        for (const auto& seg : clipResult.boundary_segments) {
-            glm::vec2 c1(seg.first.x, seg.first.y);
-            glm::vec2 c2(seg.second.x, seg.second.y);
-            std::cout << "[DEBUG] Drawing boundary segment: (" << c1.x << ", " << c1.y << ") to (" << c2.x << ", " << c2.y << ")\n";
-            std::vector<Pixel> pixels = drawWuLine2D(c1, c2);
-            for (const auto& px : pixels) {
-                if (px.intensity > 0.05) {
-                    WuVertex v;
-                    v.position = glm::vec2(px.x, px.y);
-                    v.color = glm::vec4(1.0f, 0.0f, 1.0f, px.intensity);
-                    wu_vertex_buffer.push_back(v);
-                }
-            }
+    const ProjectedVertices& screenVerts = projectToScreenSpace(model, view, projection, screenWidth, screenHeight);
+
+    // 2. Clip either each unique edge once or every face outline
+    ClipResult segments = wuEdgeSource == UNIQUE_EDGES ? clipToViewport(screenVerts, viewport)
+                                                       : clipFacesToViewport(screenVerts, viewport);
+
+    // 3. Rasterize into wu_vertex_buffer
+    const LineRasterizer* rasterizer = lineRasterizer();
+    rasterizeSegments(segments, lineColor, rasterizer ? *rasterizer : wuLineRasterizer());
+}
+
+void Mesh::rasterizeSegments(const ClipResult& segments, const glm::vec4& lineColor, const LineRasterizer& rasterizer) {
+    const size_t visibleCount = segments.visibleEdges.size();
+    const size_t total = visibleCount + segments.boundarySegments.size();
+    LOG_DEBUG("%s: %zu boundary segments", name.c_str(), segments.boundarySegments.size());
+
+    auto segmentAt = [&](size_t i) -> const std::pair<glm::vec2, glm::vec2>& {
+        return i >= visibleCount ? segments.boundarySegments[i - visibleCount] : segments.visibleEdges[i];
+    };
+    // Room needed for segments [begin, end) before the intensity filter
+    auto pixelBound = [&](size_t begin, size_t end) {
+        size_t bound = 0;
+        for (size_t i = begin; i < end; ++i) bound += rasterizer.pixelBound(segmentAt(i).first, segmentAt(i).second);
+        return bound;
+    };
+    // Appends segments [begin, end) of visibleEdges followed by boundarySegments
+    // to out, rasterizing straight into its storage
+    auto rasterizeRange = [&](size_t begin, size_t end, std::vector<WuVertex>& out) {
+        const size_t base = out.size();
+        out.resize(base + pixelBound(begin, end));
+        WuVertex* dst = out.data() + base;
+        for (size_t i = begin; i < end; ++i) {
+            const bool boundary = i >= visibleCount;
+            const auto& seg = segmentAt(i);
+            // Segments lying on the viewport border are drawn in magenta
+            const glm::vec3 rgb = boundary ? glm::vec3(1.0f, 0.0f, 1.0f) : glm::vec3(lineColor.r, lineColor.g, lineColor.b);
+            dst = rasterizer.rasterize(seg.first, seg.second, rgb, dst);
         }
+        out.resize(static_cast<size_t>(dst - out.data()));
+    };
+
+    if (!rasterPool || rasterPool->size() <= 1 || total < kParallelRasterSegments) {
+        rasterizeRange(0, total, wu_vertex_buffer);
+        return;
     }
-    
-    // 4. Update GPU
-    if (!wu_vertex_buffer.empty()) {
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_wu);
-        
-        if (wu_vertex_buffer.size() > wu_vbo_allocated_size) {
-            wu_vbo_allocated_size = wu_vertex_buffer.size() * 1.5;
-            glBufferData(GL_ARRAY_BUFFER, wu_vbo_allocated_size * sizeof(WuVertex), wu_vertex_buffer.data(), GL_DYNAMIC_DRAW);
-        } else {
-            glBufferSubData(GL_ARRAY_BUFFER, 0, wu_vertex_buffer.size() * sizeof(WuVertex), wu_vertex_buffer.data());
-        }
-        wu_point_count = wu_vertex_buffer.size();
+
+    // More chunks than threads so long and short segments even out; chunk c
+    // always holds the same segments, so concatenating in chunk order
+    // reproduces the serial output exactly
+    const size_t chunks = std::min(total, static_cast<size_t>(rasterPool->size()) * 4);
+    if (wu_chunk_buffers.size() < chunks) wu_chunk_buffers.resize(chunks);
+    rasterPool->parallelFor(total, [&](size_t begin, size_t end, size_t c) {
+        wu_chunk_buffers[c].clear();
+        rasterizeRange(begin, end, wu_chunk_buffers[c]);
+    }, chunks);
+
+    std::vector<size_t> offsets(chunks + 1, wu_vertex_buffer.size());
+    for (size_t c = 0; c < chunks; ++c) offsets[c + 1] = offsets[c] + wu_chunk_buffers[c].size();
+    wu_vertex_buffer.resize(offsets[chunks]);
+    rasterPool->run(chunks, [&](size_t c) {
+        std::copy(wu_chunk_buffers[c].begin(), wu_chunk_buffers[c].end(), wu_vertex_buffer.begin() + offsets[c]);
+    });
+}
+
+void Mesh::drawToFramebuffer(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection,
+    int screenWidth, int screenHeight, const glm::vec4& lineColor, const ViewportRect& viewport, TileFramebuffer& framebuffer) {
+    const ProjectedVertices& screenVerts = projectToScreenSpace(model, view, projection, screenWidth, screenHeight);
+    ClipResult segments = wuEdgeSource == UNIQUE_EDGES ? clipToViewport(screenVerts, viewport)
+                                                       : clipFacesToViewport(screenVerts, viewport);
+    framebuffer.drawSegments(segments.visibleEdges, lineColor, rasterPool);
+    // Segments lying on the viewport border are drawn in magenta
+    LOG_DEBUG("%s: %zu boundary segments", name.c_str(), segments.boundarySegments.size());
+    framebuffer.drawSegments(segments.boundarySegments, glm::vec4(1.0f, 0.0f, 1.0f, 1.0f), rasterPool);
+}
+
+void Mesh::drawWithGL(Shader* shader, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection,
+    int screenHeight, const glm::vec4& lineColor, const ViewportRect& viewport) {
+    shader->activate();
+    shader->setMat4("u_model", model);
+    shader->setMat4("u_view", view);
+    shader->setMat4("u_projection", projection);
+    shader->setVec4("vertexColor", lineColor);
+
+    // The viewport rectangle is in top-left screen coordinates, GL's scissor box is bottom-left
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(viewport.x_min, screenHeight - viewport.y_max, viewport.x_max - viewport.x_min, viewport.y_max - viewport.y_min);
+    glDisable(GL_DEPTH_TEST);
+
+    glBindVertexArray(VAO_gl);
+    if (currentRenderMode == POINTS) {
+        glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(points.size()));
     } else {
-        wu_point_count = 0;
+        glDrawElements(GL_LINES, static_cast<GLsizei>(edge_indices.size() * 2), GL_UNSIGNED_INT, (void*)0);
     }
-    
+    glBindVertexArray(0);
+
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_SCISSOR_TEST);
+}
+
+void Mesh::drawGpuLines(Shader* shader, const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection,
+    int screenWidth, int screenHeight, const glm::vec4& lineColor, const ViewportRect& viewport) {
+    if (!gpuLinesSupported) return;
+    shader->activate();
+    shader->setMat4("u_mvp", projection * view * model);
+    shader->setVec2("u_screenSize", glm::vec2(screenWidth, screenHeight));
+    shader->setVec4("u_color", lineColor);
+    shader->setFloat("u_lineWidth", 1.0f);
+    shader->setInt("u_positions", 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_BUFFER, positionTexture);
+
+    // The viewport rectangle is in top-left screen coordinates, GL's scissor box is bottom-left
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(viewport.x_min, screenHeight - viewport.y_max, viewport.x_max - viewport.x_min, viewport.y_max - viewport.y_min);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_DEPTH_TEST);
+
+    // One quad per edge; nothing on the CPU depends on the mesh size
+    glBindVertexArray(VAO_gpu);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(edge_indices.size()));
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+    glEnable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_SCISSOR_TEST);
+}
+
+void Mesh::drawRasterizedLines(Shader* shader,
+    const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, int screenWidth, int screenHeight, const glm::vec4& lineColor, const ViewportRect& viewport) {
+    buildLineVertices(model, view, projection, screenWidth, screenHeight, lineColor, viewport);
+
+    // 4. Update GPU: append to this frame's region of the shared stream
+    wu_point_count = static_cast<unsigned int>(wu_vertex_buffer.size());
+    wuRange = GpuBufferPool::Range();
+    if (wu_point_count > 0 && gpuPool) wuRange = gpuPool->streamPoints(wu_vertex_buffer.data(), wu_vertex_buffer.size());
+
     // 5. Render
-    if (wu_point_count > 0) {
+    if (wuRange.count > 0) {
         shader->activate();
         shader->setVec2("u_screenSize", {screenWidth, screenHeight});
 
@@ -174,9 +417,7 @@ void Mesh::drawWithXiaolinWu(Shader* shader,
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glDisable(GL_DEPTH_TEST); // Disable depth to ensure markers draw on top of everything
 
-        glBindVertexArray(VAO_wu);
-        glDrawArrays(GL_POINTS, 0, wu_point_count);
-        glBindVertexArray(0);
+        gpuPool->drawPoints(wuRange);
 
         glEnable(GL_DEPTH_TEST);
         glDisable(GL_BLEND);
@@ -184,42 +425,84 @@ void Mesh::drawWithXiaolinWu(Shader* shader,
 }
 
 // Project all mesh vertices to screen space
-std::vector<glm::vec2> Mesh::projectToScreenSpace(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, int screenWidth, int screenHeight) {
-    std::vector<glm::vec2> projected;
-    for (const auto& v : verticesHE) {
-        glm::vec3 world = glm::vec3(model * glm::vec4(v.x, v.y, v.z, 1.0f));
-        glm::vec2 screen = projectWorldToScreen(world, view, projection, screenWidth, screenHeight);
-        projected.push_back(screen);
+const ProjectedVertices& Mesh::projectToScreenSpace(const glm::mat4& model, const glm::mat4& view, const glm::mat4& projection, int screenWidth, int screenHeight) {
+    if (positionsSoA.size() != points.size()) {
+        positionsSoA.assign(points);
     }
+    projectPositions(positionsSoA, projection * view * model, screenWidth, screenHeight, projected);
     return projected;
 }
 
 // Clip all mesh edges to the viewport, return a list of visible edge segments (in screen space)
-Mesh::ClipResult Mesh::clipToViewport(const std::vector<glm::vec2>& screenVerts, const ViewportRect& viewport) {
-    float xMin = static_cast<float>(viewport.x_min);
-    float yMin = static_cast<float>(viewport.y_min);
-    float xMax = static_cast<float>(viewport.x_max);
-    float yMax = static_cast<float>(viewport.y_max);
-    WA_Viewport vp{xMin, yMin, xMax, yMax};
+Mesh::ClipResult Mesh::clipToViewport(const ProjectedVertices& screenVerts, const ViewportRect& viewport) {
+    WA_Viewport vp{
+        static_cast<float>(viewport.x_min), static_cast<float>(viewport.y_min),
+        static_cast<float>(viewport.x_max), static_cast<float>(viewport.y_max)};
+    // Gather both ends of every edge that survives the frustum (edges crossing the
+    // near or far plane are clipped in clip space), clip them all in one SIMD
+    // batch, then keep the survivors in edge order
+    const size_t edgeCount = edge_indices.size();
+    edgeSegments.resize(edgeCount);
+    size_t gathered = 0;
+    for (size_t i = 0; i < edgeCount; ++i) {
+        glm::vec2 a, b;
+        if (!clipEdgeToFrustum(positionsSoA, screenVerts, edge_indices[i].first, edge_indices[i].second, a, b)) continue;
+        edgeSegments.x0[gathered] = a.x;
+        edgeSegments.y0[gathered] = a.y;
+        edgeSegments.x1[gathered] = b.x;
+        edgeSegments.y1[gathered] = b.y;
+        ++gathered;
+    }
+    edgeSegments.resize(gathered);
+    clipSegments(edgeSegments, vp);
+
     ClipResult result;
+    result.visibleEdges.reserve(gathered);
+    for (size_t i = 0; i < gathered; ++i) {
+        const uint8_t segmentClass = edgeSegments.segmentClass[i];
+        if (segmentClass == SEGMENT_REJECTED) continue;
+        const glm::vec2 p1(edgeSegments.x0[i], edgeSegments.y0[i]);
+        const glm::vec2 p2(edgeSegments.x1[i], edgeSegments.y1[i]);
+        if (segmentClass == SEGMENT_BORDER) {
+            result.boundarySegments.emplace_back(p1, p2);
+        } else {
+            result.visibleEdges.emplace_back(p1, p2);
+        }
+    }
+    return result;
+}
+
+// Clip all mesh edges to a lasso/stencil region with the full Weiler-Atherton edge walk
+Mesh::ClipResult Mesh::clipToRegion(const ProjectedVertices& screenVerts, const WA_ClipRegion& region) {
+    ClipResult result;
+    std::vector<std::pair<WA_Point, WA_Point>> pieces;
+    WA_SegmentScratch scratch;
     for (const auto& edge : edge_indices) {
-        glm::vec2 p1 = screenVerts[edge.first];
-        glm::vec2 p2 = screenVerts[edge.second];
-        WA_Polygon seg = { WA_Point(p1.x, p1.y), WA_Point(p2.x, p2.y) };
-        WA_ClipResult clipResult = weiler_atherton_clip(seg, vp);
-        // Collect visible edges
-        const WA_Polygon& clipped = clipResult.clipped;
-        for (size_t i = 0; i + 1 < clipped.size(); ++i) {
-            glm::vec2 c1(clipped[i].x, clipped[i].y);
-            glm::vec2 c2(clipped[i+1].x, clipped[i+1].y);
-            result.visibleEdges.emplace_back(c1, c2);
+        glm::vec2 a, b;
+        if (!clipEdgeToFrustum(positionsSoA, screenVerts, edge.first, edge.second, a, b)) continue;
+        pieces.clear();
+        weiler_atherton_clip_segment(WA_Point(a.x, a.y), WA_Point(b.x, b.y), region, pieces, scratch);
+        for (const auto& piece : pieces) {
+            result.visibleEdges.emplace_back(glm::vec2(piece.first.x, piece.first.y), glm::vec2(piece.second.x, piece.second.y));
         }
-        // Collect boundary segments
-        for (const auto& bseg : clipResult.boundary_segments) {
-            result.boundarySegments.emplace_back(
-                glm::vec2(bseg.first.x, bseg.first.y),
-                glm::vec2(bseg.second.x, bseg.second.y)
-            );
+    }
+    return result;
+}
+
+// Clip every face polygon to the viewport; interior edges come out once per face
+Mesh::ClipResult Mesh::clipFacesToViewport(const ProjectedVertices& screenVerts, const ViewportRect& viewport) {
+    WA_Viewport vp{
+        static_cast<float>(viewport.x_min), static_cast<float>(viewport.y_min),
+        static_cast<float>(viewport.x_max), static_cast<float>(viewport.y_max)};
+    weiler_atherton_clip_faces(face_indices, screenVerts, vp, clippedFaces, &positionsSoA);
+    ClipResult result;
+    result.visibleEdges.reserve(clippedFaces.offsets[clippedFaces.size()]);
+    // Outline of each clipped polygon
+    for (size_t p = 0; p < clippedFaces.size(); ++p) {
+        const glm::vec2* poly = clippedFaces.polygon(p);
+        const size_t n = clippedFaces.polygonSize(p);
+        for (size_t i = 0; i < n; ++i) {
+            result.visibleEdges.emplace_back(poly[i], poly[(i + 1) % n]);
         }
     }
     return result;
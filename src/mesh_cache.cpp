@@ -0,0 +1,241 @@
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "mapped_file.hpp"
+#include "mesh.hpp"
+#include "mesh_cache.hpp"
+
+namespace {
+
+const char kMagic[8] = {'C', 'G', 'M', 'E', 'S', 'H', '\0', '\0'};
+// Bump whenever the layout below changes
+const uint32_t kVersion = 1;
+
+// File layout: the header, then each array in the order listed in
+// forEachSection(), every array starting on an 8-byte boundary.
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+    uint64_t vertexCount;
+    uint64_t faceCount;
+    uint64_t faceIndexCount;
+    uint64_t halfEdgeCount;
+    uint64_t edgeCount;
+};
+
+size_t alignUp(size_t n) {
+    return (n + 7) & ~size_t(7);
+}
+
+// The counts come from an untrusted file: each must fit in fileSize bytes on its
+// own before sectionSizes() multiplies it, so no section size can wrap around
+bool countsFit(const CacheHeader& h, size_t fileSize) {
+    return h.vertexCount <= fileSize / (3 * sizeof(float)) && h.faceCount < fileSize / sizeof(int32_t) &&
+           h.faceIndexCount <= fileSize / sizeof(int32_t) && h.halfEdgeCount <= fileSize / sizeof(uint32_t) &&
+           h.edgeCount <= fileSize / (2 * sizeof(uint32_t));
+}
+
+// Byte sizes of the sections, in file order
+std::vector<size_t> sectionSizes(const CacheHeader& h) {
+    return {
+        h.vertexCount * 3 * sizeof(float),          // positions
+        (h.faceCount + 1) * sizeof(int32_t),        // face offsets
+        h.faceIndexCount * sizeof(int32_t),         // face indices
+        h.halfEdgeCount * sizeof(uint32_t),         // half-edge origin
+        h.halfEdgeCount * sizeof(uint32_t),         // half-edge twin
+        h.halfEdgeCount * sizeof(uint32_t),         // half-edge next
+        h.halfEdgeCount * sizeof(uint32_t),         // half-edge face
+        h.vertexCount * sizeof(uint32_t),           // vertex outgoing half-edge
+        h.faceCount * sizeof(uint32_t),             // face half-edge
+        h.edgeCount * 2 * sizeof(uint32_t),         // unique edges
+    };
+}
+
+// Hash 8 bytes at a time; only needs to detect changed files, not resist attacks
+uint64_t hashBytes(const char* data, size_t size) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * 0x100000001B3ull;
+    }
+    return h ^ (h >> 29);
+}
+
+} // namespace
+
+std::string meshCachePathFor(const std::string& sourcePath) {
+    return sourcePath + ".cgmc";
+}
+
+bool computeMeshCacheKey(const std::string& sourcePath, MeshCacheKey& key, bool withHash) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(sourcePath, ec);
+    if (ec) return false;
+    auto mtime = std::filesystem::last_write_time(sourcePath, ec);
+    if (ec) return false;
+    key.sourceSize = size;
+    key.sourceMtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    key.sourceHash = 0;
+    if (withHash) {
+        MappedFile file;
+        if (!file.open(sourcePath)) return false;
+        key.sourceHash = hashBytes(file.data(), file.size());
+    }
+    return true;
+}
+
+bool readMeshCache(const std::string& cachePath, const std::string& sourcePath, Mesh& mesh) {
+    MappedFile file;
+    if (!file.open(cachePath) || file.size() < sizeof(CacheHeader)) return false;
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.headerSize != sizeof(CacheHeader)) {
+        return false;
+    }
+
+    // Cheap checks first, hash the source only if they pass
+    MeshCacheKey key;
+    if (!computeMeshCacheKey(sourcePath, key, false) ||
+        key.sourceSize != header.sourceSize || key.sourceMtime != header.sourceMtime) {
+        return false;
+    }
+    if (!computeMeshCacheKey(sourcePath, key, true) || key.sourceHash != header.sourceHash) {
+        return false;
+    }
+
+    if (!countsFit(header, file.size())) return false;
+    std::vector<size_t> sizes = sectionSizes(header);
+    std::vector<const char*> sections;
+    size_t offset = alignUp(sizeof(CacheHeader));
+    for (size_t bytes : sizes) {
+        if (offset > file.size() || bytes > file.size() - offset) return false;
+        sections.push_back(file.data() + offset);
+        offset = alignUp(offset + bytes);
+    }
+
+    const size_t V = header.vertexCount, F = header.faceCount, H = header.halfEdgeCount;
+    auto u32 = [&](int section) { return reinterpret_cast<const uint32_t*>(sections[section]); };
+
+    // Validate every stored index before the mesh is traversed
+    const uint32_t* origin = u32(3);
+    const uint32_t* twin = u32(4);
+    const uint32_t* next = u32(5);
+    const uint32_t* face = u32(6);
+    const uint32_t* vertexEdge = u32(7);
+    const uint32_t* faceEdge = u32(8);
+    for (size_t i = 0; i < H; ++i) {
+        if (origin[i] >= V || next[i] >= H || face[i] >= F || (twin[i] != HE_INVALID && twin[i] >= H)) return false;
+    }
+    for (size_t i = 0; i < V; ++i) {
+        if (vertexEdge[i] != HE_INVALID && vertexEdge[i] >= H) return false;
+    }
+    for (size_t i = 0; i < F; ++i) {
+        if (faceEdge[i] >= H) return false;
+    }
+    const int32_t* faceOffsets = reinterpret_cast<const int32_t*>(sections[1]);
+    const int32_t* faceIndices = reinterpret_cast<const int32_t*>(sections[2]);
+    if (faceOffsets[0] != 0 || static_cast<uint64_t>(faceOffsets[F]) != header.faceIndexCount) return false;
+    for (size_t i = 0; i < F; ++i) {
+        if (faceOffsets[i + 1] < faceOffsets[i]) return false;
+    }
+    for (size_t i = 0; i < header.faceIndexCount; ++i) {
+        if (faceIndices[i] < 0 || static_cast<size_t>(faceIndices[i]) >= V) return false;
+    }
+    const uint32_t* edges = u32(9);
+    for (size_t i = 0; i < header.edgeCount * 2; ++i) {
+        if (edges[i] >= V) return false;
+    }
+
+    // Bulk copies straight out of the mapping; nothing is parsed or rebuilt
+    const Point* positions = reinterpret_cast<const Point*>(sections[0]);
+    mesh.points.assign(positions, positions + V);
+    mesh.face_indices.offsets.assign(faceOffsets, faceOffsets + F + 1);
+    mesh.face_indices.indices.assign(faceIndices, faceIndices + header.faceIndexCount);
+
+    HalfEdgeMesh& he = mesh.halfEdgeMesh;
+    he.origin.assign(origin, origin + H);
+    he.twin.assign(twin, twin + H);
+    he.next.assign(next, next + H);
+    he.face.assign(face, face + H);
+    he.vertexEdge.assign(vertexEdge, vertexEdge + V);
+    he.faceEdge.assign(faceEdge, faceEdge + F);
+
+    mesh.edge_indices.resize(header.edgeCount);
+    for (size_t i = 0; i < header.edgeCount; ++i) {
+        mesh.edge_indices[i] = {edges[2 * i], edges[2 * i + 1]};
+    }
+    return true;
+}
+
+bool writeMeshCache(const std::string& cachePath, const MeshCacheKey& key, const Mesh& mesh) {
+    const HalfEdgeMesh& he = mesh.halfEdgeMesh;
+    const size_t V = he.vertexCount(), H = he.halfEdgeCount(), F = he.faceCount();
+    if (H == 0 || mesh.points.size() != V) return false;
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.headerSize = sizeof(CacheHeader);
+    header.sourceSize = key.sourceSize;
+    header.sourceMtime = key.sourceMtime;
+    header.sourceHash = key.sourceHash;
+    header.vertexCount = V;
+    header.faceCount = F;
+    header.faceIndexCount = mesh.face_indices.indices.size();
+    header.halfEdgeCount = H;
+    header.edgeCount = mesh.edge_indices.size();
+
+    std::vector<uint32_t> edges;
+    edges.reserve(mesh.edge_indices.size() * 2);
+    for (const auto& e : mesh.edge_indices) {
+        edges.push_back(e.first);
+        edges.push_back(e.second);
+    }
+
+    const void* data[] = {
+        mesh.points.data(), mesh.face_indices.offsets.data(), mesh.face_indices.indices.data(),
+        he.origin.data(), he.twin.data(), he.next.data(), he.face.data(), he.vertexEdge.data(), he.faceEdge.data(),
+        edges.data(),
+    };
+    std::vector<size_t> sizes = sectionSizes(header);
+
+    const std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        const char zeros[8] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(zeros, alignUp(sizeof(header)) - sizeof(header));
+        for (size_t s = 0; s < sizes.size(); ++s) {
+            out.write(static_cast<const char*>(data[s]), sizes[s]);
+            out.write(zeros, alignUp(sizes[s]) - sizes[s]);
+        }
+        if (!out.good()) {
+            out.close();
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    // Readers never see a partially written cache
+    if (std::rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+#include "mapped_file.hpp"
+#include "obj_loader.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+// Powers of ten that are exactly representable as double
+const double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+inline bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+inline bool isTokenEnd(char c) {
+    return isBlank(c) || c == '\n' || c == '\r' || c == '#';
+}
+
+inline const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && isBlank(*p)) ++p;
+    return p;
+}
+
+inline const char* skipToken(const char* p, const char* end) {
+    while (p < end && !isTokenEnd(*p)) ++p;
+    return p;
+}
+
+inline const char* nextLine(const char* p, const char* end) {
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return nl ? nl + 1 : end;
+}
+
+// Slow path for tokens the fast path cannot represent exactly (inf, nan,
+// very long mantissas, large exponents). The input is not null-terminated,
+// so the token is copied before handing it to strtod.
+float parseFloatSlow(const char* start, const char* end) {
+    char buf[64];
+    size_t len = static_cast<size_t>(skipToken(start, end) - start);
+    if (len >= sizeof(buf)) len = sizeof(buf) - 1;
+    std::memcpy(buf, start, len);
+    buf[len] = '\0';
+    return static_cast<float>(std::strtod(buf, nullptr));
+}
+
+// Parse a decimal float at p and advance p past it. Returns false if no
+// number starts at p.
+bool parseFloat(const char*& p, const char* end, float& out) {
+    const char* start = p;
+    const char* s = p;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        ++s;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    for (; s < end && isDigit(*s); ++s, any = true) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*s - '0');
+            if (mantissa) ++digits;
+        } else {
+            ++exponent;
+        }
+    }
+    if (s < end && *s == '.') {
+        ++s;
+        for (; s < end && isDigit(*s); ++s, any = true) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*s - '0');
+                if (mantissa) ++digits;
+                --exponent;
+            }
+        }
+    }
+    if (!any) {
+        if (s < end && !isTokenEnd(*s)) {
+            // inf / nan and friends
+            out = parseFloatSlow(start, end);
+            p = skipToken(s, end);
+            return true;
+        }
+        return false;
+    }
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const char* e = s + 1;
+        bool expNegative = false;
+        if (e < end && (*e == '-' || *e == '+')) {
+            expNegative = (*e == '-');
+            ++e;
+        }
+        if (e < end && isDigit(*e)) {
+            int expValue = 0;
+            for (; e < end && isDigit(*e); ++e) {
+                if (expValue < 10000) expValue = expValue * 10 + (*e - '0');
+            }
+            exponent += expNegative ? -expValue : expValue;
+            s = e;
+        }
+    }
+
+    if (mantissa >= (uint64_t(1) << 53) || exponent < -22 || exponent > 22) {
+        out = parseFloatSlow(start, end);
+    } else {
+        // Both operands are exact, so the division/multiplication is correctly rounded
+        double value = static_cast<double>(mantissa);
+        value = exponent < 0 ? value / kPow10[-exponent] : value * kPow10[exponent];
+        out = static_cast<float>(negative ? -value : value);
+    }
+    p = s;
+    return true;
+}
+
+// Parse a signed decimal integer at p and advance p past it; fails if its
+// magnitude does not fit in an int
+bool parseInt(const char*& p, const char* end, long long& out) {
+    const char* s = p;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        ++s;
+    }
+    if (s >= end || !isDigit(*s)) return false;
+    long long value = 0;
+    for (; s < end && isDigit(*s); ++s) {
+        value = value * 10 + (*s - '0');
+        if (value > std::numeric_limits<int>::max()) return false;
+    }
+    out = negative ? -value : value;
+    p = s;
+    return true;
+}
+
+} // namespace
+
+namespace {
+
+// Parse [begin, end) into out. Negative indices are resolved against the
+// vertices parsed so far in this range; when relativeSlots is given, the
+// positions of those entries in out.faces.indices are recorded so a caller
+// stitching several ranges can rebase them. Returns false at the first face
+// index that is 0, not an integer or outside the int range.
+bool parseRange(const char* begin, const char* end, ObjMeshData& out, std::vector<size_t>* relativeSlots) {
+    const char* p = begin;
+    while (p < end) {
+        p = skipBlanks(p, end);
+        if (p + 1 < end && isBlank(p[1])) {
+            if (p[0] == 'v') {
+                // Vertex position: v x y z [w]
+                p += 2;
+                Point pt{0.0f, 0.0f, 0.0f};
+                float* coords[3] = {&pt.x, &pt.y, &pt.z};
+                for (float* c : coords) {
+                    p = skipBlanks(p, end);
+                    if (!parseFloat(p, end, *c)) break;
+                }
+                out.points.push_back(pt);
+            } else if (p[0] == 'f') {
+                // Face: f v1[/vt1[/vn1]] v2... ; only the position index is kept
+                p += 2;
+                const long long vertexCount = static_cast<long long>(out.points.size());
+                bool any = false;
+                while (true) {
+                    p = skipBlanks(p, end);
+                    if (p >= end || *p == '\n' || *p == '\r' || *p == '#') break;
+                    long long idx;
+                    if (!parseInt(p, end, idx) || idx == 0) return false;
+                    // OBJ is 1-based; negative indices count back from the last vertex
+                    if (idx < 0 && relativeSlots) relativeSlots->push_back(out.faces.indices.size());
+                    const long long resolved = idx > 0 ? idx - 1 : vertexCount + idx;
+                    if (resolved > std::numeric_limits<int>::max()) return false;
+                    out.faces.indices.push_back(static_cast<int>(resolved));
+                    any = true;
+                    p = skipToken(p, end);
+                }
+                if (any) out.faces.endFace();
+            }
+        }
+        p = nextLine(p, end);
+    }
+    return true;
+}
+
+// Per-chunk output of the parallel parser
+struct ChunkResult {
+    ObjMeshData data;
+    std::vector<size_t> relativeSlots;
+    bool ok = true;
+};
+
+} // namespace
+
+bool parseOBJ(const char* begin, const char* end, ObjMeshData& out) {
+    out.clear();
+    if (!parseRange(begin, end, out, nullptr)) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+bool parseOBJParallel(const char* begin, const char* end, ObjMeshData& out, ThreadPool& pool) {
+    out.clear();
+    const size_t size = static_cast<size_t>(end - begin);
+    // A few chunks per thread keeps the load balanced when records vary in length
+    size_t chunkCount = std::min<size_t>(static_cast<size_t>(pool.size()) * 4, size / 4096 + 1);
+    if (chunkCount <= 1) return parseOBJ(begin, end, out);
+
+    // Chunk boundaries sit just after a newline so no record is split
+    std::vector<const char*> bounds(chunkCount + 1);
+    bounds[0] = begin;
+    bounds[chunkCount] = end;
+    for (size_t c = 1; c < chunkCount; ++c) {
+        const char* b = begin + size * c / chunkCount;
+        if (b < bounds[c - 1]) b = bounds[c - 1];
+        bounds[c] = (b > begin && b[-1] == '\n') ? b : nextLine(b, end);
+    }
+
+    std::vector<ChunkResult> chunks(chunkCount);
+    pool.run(chunkCount, [&](size_t c) {
+        chunks[c].data.clear();
+        chunks[c].ok = parseRange(bounds[c], bounds[c + 1], chunks[c].data, &chunks[c].relativeSlots);
+    });
+    for (const ChunkResult& chunk : chunks) {
+        if (!chunk.ok) return false;
+    }
+
+    // Prefix sums give every chunk its place in the output arrays
+    std::vector<size_t> pointBase(chunkCount + 1, 0), faceBase(chunkCount + 1, 0), indexBase(chunkCount + 1, 0);
+    for (size_t c = 0; c < chunkCount; ++c) {
+        pointBase[c + 1] = pointBase[c] + chunks[c].data.points.size();
+        faceBase[c + 1] = faceBase[c] + chunks[c].data.faces.size();
+        indexBase[c + 1] = indexBase[c] + chunks[c].data.faces.indices.size();
+    }
+    out.points.resize(pointBase[chunkCount]);
+    out.faces.offsets.resize(faceBase[chunkCount] + 1);
+    out.faces.indices.resize(indexBase[chunkCount]);
+
+    pool.run(chunkCount, [&](size_t c) {
+        const ObjMeshData& src = chunks[c].data;
+        std::copy(src.points.begin(), src.points.end(), out.points.begin() + pointBase[c]);
+
+        int* indices = out.faces.indices.data() + indexBase[c];
+        std::copy(src.faces.indices.begin(), src.faces.indices.end(), indices);
+        // Relative indices were resolved against the chunk's own vertices
+        const int rebase = static_cast<int>(pointBase[c]);
+        for (size_t slot : chunks[c].relativeSlots) indices[slot] += rebase;
+
+        const int offsetBase = static_cast<int>(indexBase[c]);
+        int* offsets = out.faces.offsets.data() + faceBase[c];
+        for (size_t f = 1; f < src.faces.offsets.size(); ++f) {
+            offsets[f] = src.faces.offsets[f] + offsetBase;
+        }
+    });
+    return true;
+}
+
+bool validateOBJIndices(const ObjMeshData& data) {
+    const int vertexCount = static_cast<int>(data.points.size());
+    for (int idx : data.faces.indices) {
+        if (idx < 0 || idx >= vertexCount) return false;
+    }
+    return true;
+}
+
+bool loadOBJ(const std::string& filename, ObjMeshData& out, unsigned threads) {
+    out.clear();
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::cerr << "Could not open " << filename << std::endl;
+        return false;
+    }
+    threads = ThreadPool::resolveThreadCount(threads);
+    bool parsed;
+    if (threads > 1) {
+        ThreadPool pool(threads);
+        parsed = parseOBJParallel(file.begin(), file.end(), out, pool);
+    } else {
+        parsed = parseOBJ(file.begin(), file.end(), out);
+    }
+    if (!parsed) {
+        std::cerr << "Malformed face index (0, not an integer or too large) in " << filename << std::endl;
+        out.clear();
+        return false;
+    }
+    if (!validateOBJIndices(out)) {
+        std::cerr << "Face index out of range in " << filename << std::endl;
+        out.clear();
+        return false;
+    }
+    return true;
+}
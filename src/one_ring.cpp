@@ -0,0 +1,105 @@
+#include <algorithm>
+
+#include "one_ring.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+// Visit (face, outgoing half-edge) around v in the same order as
+// getFacesOfVertex(): forward through twin->next, then backward from the
+// start edge's predecessor if a boundary was hit.
+template <class F>
+void walkRing(const HalfEdgeMesh& mesh, const std::vector<HEIndex>& prev, HEIndex v, F&& emit) {
+    const HEIndex start = mesh.vertexEdge[v];
+    if (start == HE_INVALID) return;
+    // Guards against cycles that never return to start on malformed input
+    size_t steps = mesh.halfEdgeCount();
+
+    HEIndex current = start;
+    do {
+        emit(mesh.face[current], current);
+        const HEIndex t = mesh.twin[current];
+        current = t != HE_INVALID ? mesh.next[t] : HE_INVALID;
+    } while (current != HE_INVALID && current != start && --steps > 0);
+
+    if (current == HE_INVALID) {
+        current = mesh.twin[prev[start]];
+        while (current != HE_INVALID && --steps > 0) {
+            emit(mesh.face[current], current);
+            current = mesh.twin[prev[current]];
+        }
+    }
+}
+
+// Sorted, unique half-edges that start or end at v within its faces
+void gatherIncident(const HalfEdgeMesh& mesh, const std::vector<HEIndex>& prev, HEIndex v, std::vector<HEIndex>& out) {
+    out.clear();
+    walkRing(mesh, prev, v, [&](HEIndex f, HEIndex) {
+        const HEIndex start = mesh.faceEdge[f];
+        HEIndex he = start;
+        do {
+            if (mesh.origin[he] == v || mesh.dest(he) == v) out.push_back(he);
+            he = mesh.next[he];
+        } while (he != start);
+    });
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+template <class F>
+void forVertexRanges(ThreadPool* pool, size_t count, F&& fn) {
+    if (pool && pool->size() > 1 && count >= 4096) {
+        pool->parallelFor(count, fn);
+    } else if (count > 0) {
+        fn(size_t(0), count, size_t(0));
+    }
+}
+
+} // namespace
+
+void buildVertexOneRing(const HalfEdgeMesh& mesh, VertexOneRing& ring, ThreadPool* pool) {
+    const size_t H = mesh.halfEdgeCount();
+    const size_t V = mesh.vertexCount();
+
+    // next is a permutation within each face loop, so every slot is written once
+    ring.prev.assign(H, HE_INVALID);
+    forVertexRanges(pool, H, [&](size_t begin, size_t end, size_t) {
+        for (size_t he = begin; he < end; ++he) ring.prev[mesh.next[he]] = static_cast<HEIndex>(he);
+    });
+
+    // Pass 1: sizes per vertex
+    ring.ringOffsets.assign(V + 1, 0);
+    ring.incidentOffsets.assign(V + 1, 0);
+    forVertexRanges(pool, V, [&](size_t begin, size_t end, size_t) {
+        std::vector<HEIndex> scratch;
+        for (size_t v = begin; v < end; ++v) {
+            HEIndex count = 0;
+            walkRing(mesh, ring.prev, static_cast<HEIndex>(v), [&](HEIndex, HEIndex) { ++count; });
+            ring.ringOffsets[v + 1] = count;
+            gatherIncident(mesh, ring.prev, static_cast<HEIndex>(v), scratch);
+            ring.incidentOffsets[v + 1] = static_cast<HEIndex>(scratch.size());
+        }
+    });
+    for (size_t v = 0; v < V; ++v) {
+        ring.ringOffsets[v + 1] += ring.ringOffsets[v];
+        ring.incidentOffsets[v + 1] += ring.incidentOffsets[v];
+    }
+
+    // Pass 2: fill
+    ring.ringFaces.resize(ring.ringOffsets[V]);
+    ring.ringOutgoing.resize(ring.ringOffsets[V]);
+    ring.incidentEdges.resize(ring.incidentOffsets[V]);
+    forVertexRanges(pool, V, [&](size_t begin, size_t end, size_t) {
+        std::vector<HEIndex> scratch;
+        for (size_t v = begin; v < end; ++v) {
+            HEIndex slot = ring.ringOffsets[v];
+            walkRing(mesh, ring.prev, static_cast<HEIndex>(v), [&](HEIndex f, HEIndex he) {
+                ring.ringFaces[slot] = f;
+                ring.ringOutgoing[slot] = he;
+                ++slot;
+            });
+            gatherIncident(mesh, ring.prev, static_cast<HEIndex>(v), scratch);
+            std::copy(scratch.begin(), scratch.end(), ring.incidentEdges.begin() + ring.incidentOffsets[v]);
+        }
+    });
+}
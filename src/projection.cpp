@@ -0,0 +1,273 @@
+#include "projection.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CG_PROJECTION_X86 1
+#include <immintrin.h>
+#endif
+
+void SoAPositions::assign(const std::vector<Point>& points) {
+    x.resize(points.size());
+    y.resize(points.size());
+    z.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+        z[i] = points[i].z;
+    }
+}
+
+namespace {
+
+// The rows of the MVP (clip x, y, z and w) plus the viewport scale
+struct ProjectionConstants {
+    float rx[4], ry[4], rz[4], rw[4];
+    float halfWidth, halfHeight;
+
+    ProjectionConstants(const glm::mat4& m, int width, int height) {
+        for (int c = 0; c < 4; ++c) {
+            rx[c] = m[c][0];
+            ry[c] = m[c][1];
+            rz[c] = m[c][2];
+            rw[c] = m[c][3];
+        }
+        halfWidth = 0.5f * static_cast<float>(width);
+        halfHeight = 0.5f * static_cast<float>(height);
+    }
+};
+
+// ClipPlaneBits of one clip-space position; NaN lands outside the near plane
+uint8_t clipCode(float cx, float cy, float cz, float cw) {
+    return (cx < -cw ? CLIP_LEFT : 0) | (cx > cw ? CLIP_RIGHT : 0) | (cy < -cw ? CLIP_BOTTOM : 0) |
+           (cy > cw ? CLIP_TOP : 0) | (cz + cw > 0.0f ? 0 : CLIP_NEAR) | (cz > cw ? CLIP_FAR : 0);
+}
+
+void projectScalar(const SoAPositions& p, const ProjectionConstants& k, size_t begin, size_t end, ProjectedVertices& out) {
+    for (size_t i = begin; i < end; ++i) {
+        const float x = p.x[i], y = p.y[i], z = p.z[i];
+        const float cx = k.rx[0] * x + k.rx[1] * y + k.rx[2] * z + k.rx[3];
+        const float cy = k.ry[0] * x + k.ry[1] * y + k.ry[2] * z + k.ry[3];
+        const float cz = k.rz[0] * x + k.rz[1] * y + k.rz[2] * z + k.rz[3];
+        const float cw = k.rw[0] * x + k.rw[1] * y + k.rw[2] * z + k.rw[3];
+        const uint8_t code = clipCode(cx, cy, cz, cw);
+        // In front of the near plane w >= near > 0; anything else is not divided
+        const float w = code & CLIP_NEAR ? 1.0f : cw;
+        out.screen[i] = glm::vec2((cx / w + 1.0f) * k.halfWidth, (1.0f - cy / w) * k.halfHeight);
+        out.clipCodes[i] = code;
+    }
+}
+
+#ifdef CG_PROJECTION_X86
+
+void projectSSE(const SoAPositions& p, const ProjectionConstants& k, size_t count, ProjectedVertices& out) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 hw = _mm_set1_ps(k.halfWidth), hh = _mm_set1_ps(k.halfHeight);
+    float* dst = &out.screen[0].x;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 x = _mm_loadu_ps(&p.x[i]), y = _mm_loadu_ps(&p.y[i]), z = _mm_loadu_ps(&p.z[i]);
+        auto row = [&](const float* r) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[0]), x), _mm_mul_ps(_mm_set1_ps(r[1]), y)),
+                              _mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[2]), z), _mm_set1_ps(r[3])));
+        };
+        const __m128 cx = row(k.rx), cy = row(k.ry), cz = row(k.rz), cw = row(k.rw);
+        const __m128 front = _mm_cmpgt_ps(_mm_add_ps(cz, cw), zero);
+        const __m128 w = _mm_or_ps(_mm_and_ps(front, cw), _mm_andnot_ps(front, one));
+        const __m128 sx = _mm_mul_ps(_mm_add_ps(_mm_div_ps(cx, w), one), hw);
+        const __m128 sy = _mm_mul_ps(_mm_sub_ps(one, _mm_div_ps(cy, w)), hh);
+        _mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(sx, sy));
+        _mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(sx, sy));
+
+        // One bit per plane in each 32-bit lane, then narrowed to bytes
+        const __m128 negW = _mm_sub_ps(zero, cw);
+        auto bit = [](__m128 mask, int value) { return _mm_and_si128(_mm_castps_si128(mask), _mm_set1_epi32(value)); };
+        __m128i code = _mm_or_si128(bit(_mm_cmplt_ps(cx, negW), CLIP_LEFT), bit(_mm_cmpgt_ps(cx, cw), CLIP_RIGHT));
+        code = _mm_or_si128(code, _mm_or_si128(bit(_mm_cmplt_ps(cy, negW), CLIP_BOTTOM), bit(_mm_cmpgt_ps(cy, cw), CLIP_TOP)));
+        code = _mm_or_si128(code, _mm_andnot_si128(_mm_castps_si128(front), _mm_set1_epi32(CLIP_NEAR)));
+        code = _mm_or_si128(code, bit(_mm_cmpgt_ps(cz, cw), CLIP_FAR));
+        code = _mm_packus_epi16(_mm_packs_epi32(code, code), code);
+        const int packed = _mm_cvtsi128_si32(code);
+        std::memcpy(&out.clipCodes[i], &packed, 4);
+    }
+    projectScalar(p, k, i, count, out);
+}
+
+// r[0]*x + r[1]*y + r[2]*z + r[3] for 8 vertices
+__attribute__((target("avx2"), always_inline))
+inline __m256 transformRowAVX2(const float* r, __m256 x, __m256 y, __m256 z) {
+    return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(r[0]), x), _mm256_mul_ps(_mm256_set1_ps(r[1]), y)),
+                         _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(r[2]), z), _mm256_set1_ps(r[3])));
+}
+
+// value in the lanes where mask is set, 0 elsewhere
+__attribute__((target("avx2"), always_inline))
+inline __m256i clipBitAVX2(__m256 mask, int value) {
+    return _mm256_and_si256(_mm256_castps_si256(mask), _mm256_set1_epi32(value));
+}
+
+__attribute__((target("avx2")))
+void projectAVX2(const SoAPositions& p, const ProjectionConstants& k, size_t count, ProjectedVertices& out) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 hw = _mm256_set1_ps(k.halfWidth), hh = _mm256_set1_ps(k.halfHeight);
+    float* dst = &out.screen[0].x;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 x = _mm256_loadu_ps(&p.x[i]), y = _mm256_loadu_ps(&p.y[i]), z = _mm256_loadu_ps(&p.z[i]);
+        const __m256 cx = transformRowAVX2(k.rx, x, y, z);
+        const __m256 cy = transformRowAVX2(k.ry, x, y, z);
+        const __m256 cz = transformRowAVX2(k.rz, x, y, z);
+        const __m256 cw = transformRowAVX2(k.rw, x, y, z);
+        const __m256 front = _mm256_cmp_ps(_mm256_add_ps(cz, cw), zero, _CMP_GT_OQ);
+        const __m256 w = _mm256_blendv_ps(one, cw, front);
+        const __m256 sx = _mm256_mul_ps(_mm256_add_ps(_mm256_div_ps(cx, w), one), hw);
+        const __m256 sy = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_div_ps(cy, w)), hh);
+        // unpack works per 128-bit lane: lo = v0 v1 | v4 v5, hi = v2 v3 | v6 v7
+        const __m256 lo = _mm256_unpacklo_ps(sx, sy), hi = _mm256_unpackhi_ps(sx, sy);
+        _mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+
+        const __m256 negW = _mm256_sub_ps(zero, cw);
+        __m256i code = _mm256_or_si256(clipBitAVX2(_mm256_cmp_ps(cx, negW, _CMP_LT_OQ), CLIP_LEFT),
+                                       clipBitAVX2(_mm256_cmp_ps(cx, cw, _CMP_GT_OQ), CLIP_RIGHT));
+        code = _mm256_or_si256(code, _mm256_or_si256(clipBitAVX2(_mm256_cmp_ps(cy, negW, _CMP_LT_OQ), CLIP_BOTTOM),
+                                                     clipBitAVX2(_mm256_cmp_ps(cy, cw, _CMP_GT_OQ), CLIP_TOP)));
+        code = _mm256_or_si256(code, _mm256_andnot_si256(_mm256_castps_si256(front), _mm256_set1_epi32(CLIP_NEAR)));
+        code = _mm256_or_si256(code, clipBitAVX2(_mm256_cmp_ps(cz, cw, _CMP_GT_OQ), CLIP_FAR));
+        // Narrow the 8 lanes to bytes: 32 -> 16 bit across both halves, then 16 -> 8
+        const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(code), _mm256_extracti128_si256(code, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(&out.clipCodes[i]), _mm_packus_epi16(words, words));
+    }
+    projectScalar(p, k, i, count, out);
+}
+
+#endif
+
+} // namespace
+
+ProjectionKernel bestProjectionKernel() {
+#ifdef CG_PROJECTION_X86
+    static const ProjectionKernel best =
+        __builtin_cpu_supports("avx2") ? ProjectionKernel::AVX2 : ProjectionKernel::SSE;
+    return best;
+#else
+    return ProjectionKernel::Scalar;
+#endif
+}
+
+const char* projectionKernelName(ProjectionKernel kernel) {
+    switch (kernel) {
+        case ProjectionKernel::Auto: return projectionKernelName(bestProjectionKernel());
+        case ProjectionKernel::Scalar: return "scalar";
+        case ProjectionKernel::SSE: return "SSE";
+        case ProjectionKernel::AVX2: return "AVX2";
+    }
+    return "?";
+}
+
+void projectPositions(const SoAPositions& positions, const glm::mat4& mvp, int screenWidth, int screenHeight,
+                      ProjectedVertices& out, ProjectionKernel kernel) {
+    const size_t count = positions.size();
+    out.screen.resize(count);
+    out.clipCodes.resize(count);
+    const ProjectionConstants k(mvp, screenWidth, screenHeight);
+    out.mvp = mvp;
+    out.halfWidth = k.halfWidth;
+    out.halfHeight = k.halfHeight;
+    if (count == 0) return;
+
+    if (kernel == ProjectionKernel::Auto) kernel = bestProjectionKernel();
+#ifdef CG_PROJECTION_X86
+    if (kernel == ProjectionKernel::AVX2 && bestProjectionKernel() == ProjectionKernel::AVX2) {
+        projectAVX2(positions, k, count, out);
+        return;
+    }
+    if (kernel == ProjectionKernel::SSE || kernel == ProjectionKernel::AVX2) {
+        projectSSE(positions, k, count, out);
+        return;
+    }
+#endif
+    projectScalar(positions, k, 0, count, out);
+}
+
+namespace {
+
+glm::vec4 clipPosition(const SoAPositions& positions, const ProjectedVertices& projected, size_t i) {
+    return projected.mvp * glm::vec4(positions.x[i], positions.y[i], positions.z[i], 1.0f);
+}
+
+glm::vec2 divideToScreen(const ProjectedVertices& projected, const glm::vec4& c) {
+    return glm::vec2((c.x / c.w + 1.0f) * projected.halfWidth, (1.0f - c.y / c.w) * projected.halfHeight);
+}
+
+// Signed distances to the near (z + w >= 0) and far (w - z >= 0) planes
+float nearDistance(const glm::vec4& c) { return c.z + c.w; }
+float farDistance(const glm::vec4& c) { return c.w - c.z; }
+
+} // namespace
+
+bool clipEdgeToFrustum(const SoAPositions& positions, const ProjectedVertices& projected, size_t a, size_t b,
+                       glm::vec2& screenA, glm::vec2& screenB) {
+    const uint8_t codeA = projected.clipCodes[a], codeB = projected.clipCodes[b];
+    if (codeA & codeB) return false;
+    if (!((codeA | codeB) & CLIP_DEPTH)) {
+        screenA = projected.screen[a];
+        screenB = projected.screen[b];
+        return true;
+    }
+
+    // Liang-Barsky in clip space against the two depth planes
+    const glm::vec4 ca = clipPosition(positions, projected, a), cb = clipPosition(positions, projected, b);
+    float t0 = 0.0f, t1 = 1.0f;
+    for (float (*distance)(const glm::vec4&) : {nearDistance, farDistance}) {
+        const float da = distance(ca), db = distance(cb);
+        if (da < 0.0f && db < 0.0f) return false;
+        if (da < 0.0f) t0 = std::max(t0, da / (da - db));
+        else if (db < 0.0f) t1 = std::min(t1, da / (da - db));
+    }
+    if (t0 >= t1) return false;
+    // End points with a depth code were not divided by projectPositions() (a vertex
+    // exactly on the near plane keeps t = 0 but still needs its own divide)
+    screenA = t0 > 0.0f || (codeA & CLIP_DEPTH) ? divideToScreen(projected, ca + (cb - ca) * t0) : projected.screen[a];
+    screenB = t1 < 1.0f || (codeB & CLIP_DEPTH) ? divideToScreen(projected, ca + (cb - ca) * t1) : projected.screen[b];
+    return true;
+}
+
+size_t clipFaceToFrustum(const SoAPositions& positions, const ProjectedVertices& projected, const int* face, size_t count,
+                         std::vector<glm::vec2>& out, FrustumClipScratch& scratch) {
+    out.clear();
+    uint8_t codeAnd = 0xFF, codeOr = 0;
+    for (size_t k = 0; k < count; ++k) {
+        codeAnd &= projected.clipCodes[face[k]];
+        codeOr |= projected.clipCodes[face[k]];
+    }
+    if (codeAnd) return 0;
+    if (!(codeOr & CLIP_DEPTH)) {
+        for (size_t k = 0; k < count; ++k) out.push_back(projected.screen[face[k]]);
+        return out.size();
+    }
+
+    // Sutherland-Hodgman in clip space, one pass per depth plane; each pass
+    // adds at most one vertex to a polygon that is convex after the first
+    std::vector<glm::vec4>& poly = scratch.polygon;
+    std::vector<glm::vec4>& next = scratch.next;
+    poly.resize(count);
+    for (size_t k = 0; k < count; ++k) poly[k] = clipPosition(positions, projected, static_cast<size_t>(face[k]));
+    for (float (*distance)(const glm::vec4&) : {nearDistance, farDistance}) {
+        next.clear();
+        for (size_t k = 0; k < poly.size(); ++k) {
+            const glm::vec4& cur = poly[k];
+            const glm::vec4& nxt = poly[(k + 1) % poly.size()];
+            const float dc = distance(cur), dn = distance(nxt);
+            if (dc >= 0.0f) next.push_back(cur);
+            if ((dc >= 0.0f) != (dn >= 0.0f)) next.push_back(cur + (nxt - cur) * (dc / (dc - dn)));
+        }
+        poly.swap(next);
+        if (poly.size() < 3) return 0;
+    }
+    for (const glm::vec4& c : poly) out.push_back(divideToScreen(projected, c));
+    return out.size();
+}
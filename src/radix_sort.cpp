@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <array>
+
+#include "radix_sort.hpp"
+#include "thread_pool.hpp"
+
+namespace {
+
+const unsigned kDigitBits = 8;
+const size_t kBuckets = size_t(1) << kDigitBits;
+
+} // namespace
+
+void radixSortPairs(std::vector<KeyIndex>& items, unsigned keyBits, ThreadPool* pool) {
+    const size_t n = items.size();
+    if (n < 2) return;
+    keyBits = std::min(std::max(keyBits, 1u), 64u);
+    const unsigned passes = (keyBits + kDigitBits - 1) / kDigitBits;
+
+    // One chunk per thread; small inputs are not worth splitting
+    size_t chunkCount = (pool && n >= 65536) ? pool->size() : 1;
+    std::vector<std::array<size_t, kBuckets>> counts(chunkCount);
+    std::vector<KeyIndex> scratch(n);
+    std::vector<KeyIndex>* src = &items;
+    std::vector<KeyIndex>* dst = &scratch;
+
+    auto forChunks = [&](auto&& fn) {
+        if (chunkCount > 1) {
+            pool->parallelFor(n, fn, chunkCount);
+        } else {
+            fn(size_t(0), n, size_t(0));
+        }
+    };
+
+    for (unsigned pass = 0; pass < passes; ++pass) {
+        const unsigned shift = pass * kDigitBits;
+
+        // Per-chunk digit histograms
+        forChunks([&](size_t begin, size_t end, size_t c) {
+            auto& count = counts[c];
+            count.fill(0);
+            const KeyIndex* in = src->data();
+            for (size_t i = begin; i < end; ++i) ++count[(in[i].key >> shift) & (kBuckets - 1)];
+        });
+
+        // Exclusive prefix sum in (digit, chunk) order keeps the sort stable
+        size_t sum = 0;
+        for (size_t d = 0; d < kBuckets; ++d) {
+            for (size_t c = 0; c < chunkCount; ++c) {
+                size_t count = counts[c][d];
+                counts[c][d] = sum;
+                sum += count;
+            }
+        }
+
+        forChunks([&](size_t begin, size_t end, size_t c) {
+            auto& offset = counts[c];
+            const KeyIndex* in = src->data();
+            KeyIndex* out = dst->data();
+            for (size_t i = begin; i < end; ++i) out[offset[(in[i].key >> shift) & (kBuckets - 1)]++] = in[i];
+        });
+        std::swap(src, dst);
+    }
+    if (src != &items) items.swap(*src);
+}
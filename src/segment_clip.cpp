@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cmath>
+
+#include "segment_clip.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define CG_SEGMENT_CLIP_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const float kBorderEpsilon = 1e-3f;
+
+// Sides of the viewport the point lies strictly beyond (left, right, top, bottom bits)
+inline unsigned outcode(const glm::vec2& p, const WA_Viewport& vp) {
+    return (p.x < vp.xmin ? 1u : 0u) | (p.x > vp.xmax ? 2u : 0u) | (p.y < vp.ymin ? 4u : 0u) | (p.y > vp.ymax ? 8u : 0u);
+}
+
+void clipScalar(SegmentBatch& s, const WA_Viewport& vp, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        glm::vec2 a(s.x0[i], s.y0[i]), b(s.x1[i], s.y1[i]);
+        if (!clipSegmentToViewport(a, b, vp)) {
+            s.segmentClass[i] = SEGMENT_REJECTED;
+            continue;
+        }
+        s.x0[i] = a.x;
+        s.y0[i] = a.y;
+        s.x1[i] = b.x;
+        s.y1[i] = b.y;
+        s.segmentClass[i] = onSameViewportSide(a, b, vp) ? SEGMENT_BORDER : SEGMENT_VISIBLE;
+    }
+}
+
+#ifdef CG_SEGMENT_CLIP_X86
+
+// Liang-Barsky on 4 lanes: every side updates t0/t1 under a mask instead of branching
+void clipSSE(SegmentBatch& s, const WA_Viewport& vp, size_t count) {
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 xmin = _mm_set1_ps(vp.xmin), xmax = _mm_set1_ps(vp.xmax);
+    const __m128 ymin = _mm_set1_ps(vp.ymin), ymax = _mm_set1_ps(vp.ymax);
+    const __m128 eps = _mm_set1_ps(kBorderEpsilon);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    auto select = [](__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); };
+    auto near = [&](__m128 v, __m128 edge) { return _mm_cmplt_ps(_mm_and_ps(_mm_sub_ps(v, edge), absMask), eps); };
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 x0 = _mm_loadu_ps(&s.x0[i]), y0 = _mm_loadu_ps(&s.y0[i]);
+        const __m128 x1 = _mm_loadu_ps(&s.x1[i]), y1 = _mm_loadu_ps(&s.y1[i]);
+        const __m128 dx = _mm_sub_ps(x1, x0), dy = _mm_sub_ps(y1, y0);
+
+        // Outcode rejection: both ends beyond the same side
+        __m128 reject = _mm_or_ps(_mm_or_ps(_mm_and_ps(_mm_cmplt_ps(x0, xmin), _mm_cmplt_ps(x1, xmin)),
+                                            _mm_and_ps(_mm_cmpgt_ps(x0, xmax), _mm_cmpgt_ps(x1, xmax))),
+                                  _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(y0, ymin), _mm_cmplt_ps(y1, ymin)),
+                                            _mm_and_ps(_mm_cmpgt_ps(y0, ymax), _mm_cmpgt_ps(y1, ymax))));
+        __m128 t0 = zero, t1 = one;
+        auto side = [&](__m128 p, __m128 q) {
+            reject = _mm_or_ps(reject, _mm_and_ps(_mm_cmpeq_ps(p, zero), _mm_cmplt_ps(q, zero)));
+            const __m128 t = _mm_div_ps(q, p);
+            t0 = select(_mm_cmplt_ps(p, zero), _mm_max_ps(t0, t), t0);
+            t1 = select(_mm_cmpgt_ps(p, zero), _mm_min_ps(t1, t), t1);
+        };
+        side(_mm_sub_ps(zero, dx), _mm_sub_ps(x0, xmin));
+        side(dx, _mm_sub_ps(xmax, x0));
+        side(_mm_sub_ps(zero, dy), _mm_sub_ps(y0, ymin));
+        side(dy, _mm_sub_ps(ymax, y0));
+        const __m128 accept = _mm_andnot_ps(reject, _mm_cmple_ps(t0, t1));
+
+        // Move an end only when its parameter changed, as the scalar clipper does
+        const __m128 move0 = _mm_cmpgt_ps(t0, zero), move1 = _mm_cmplt_ps(t1, one);
+        const __m128 cx0 = select(move0, _mm_add_ps(x0, _mm_mul_ps(dx, t0)), x0);
+        const __m128 cy0 = select(move0, _mm_add_ps(y0, _mm_mul_ps(dy, t0)), y0);
+        const __m128 cx1 = select(move1, _mm_add_ps(x0, _mm_mul_ps(dx, t1)), x1);
+        const __m128 cy1 = select(move1, _mm_add_ps(y0, _mm_mul_ps(dy, t1)), y1);
+        _mm_storeu_ps(&s.x0[i], cx0);
+        _mm_storeu_ps(&s.y0[i], cy0);
+        _mm_storeu_ps(&s.x1[i], cx1);
+        _mm_storeu_ps(&s.y1[i], cy1);
+
+        const __m128 border = _mm_or_ps(
+            _mm_or_ps(_mm_and_ps(near(cx0, xmin), near(cx1, xmin)), _mm_and_ps(near(cx0, xmax), near(cx1, xmax))),
+            _mm_or_ps(_mm_and_ps(near(cy0, ymin), near(cy1, ymin)), _mm_and_ps(near(cy0, ymax), near(cy1, ymax))));
+        const int acceptBits = _mm_movemask_ps(accept), borderBits = _mm_movemask_ps(border);
+        for (int j = 0; j < 4; ++j) {
+            s.segmentClass[i + j] = !((acceptBits >> j) & 1) ? SEGMENT_REJECTED
+                                  : ((borderBits >> j) & 1)  ? SEGMENT_BORDER
+                                                             : SEGMENT_VISIBLE;
+        }
+    }
+    clipScalar(s, vp, i, count);
+}
+
+__attribute__((target("avx2"), always_inline))
+inline __m256 selectAVX2(__m256 mask, __m256 a, __m256 b) {
+    return _mm256_blendv_ps(b, a, mask);
+}
+
+__attribute__((target("avx2"), always_inline))
+inline __m256 nearAVX2(__m256 v, __m256 edge, __m256 absMask, __m256 eps) {
+    return _mm256_cmp_ps(_mm256_and_ps(_mm256_sub_ps(v, edge), absMask), eps, _CMP_LT_OQ);
+}
+
+// Same as clipSSE on 8 lanes
+__attribute__((target("avx2")))
+void clipAVX2(SegmentBatch& s, const WA_Viewport& vp, size_t count) {
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 xmin = _mm256_set1_ps(vp.xmin), xmax = _mm256_set1_ps(vp.xmax);
+    const __m256 ymin = _mm256_set1_ps(vp.ymin), ymax = _mm256_set1_ps(vp.ymax);
+    const __m256 eps = _mm256_set1_ps(kBorderEpsilon);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 x0 = _mm256_loadu_ps(&s.x0[i]), y0 = _mm256_loadu_ps(&s.y0[i]);
+        const __m256 x1 = _mm256_loadu_ps(&s.x1[i]), y1 = _mm256_loadu_ps(&s.y1[i]);
+        const __m256 dx = _mm256_sub_ps(x1, x0), dy = _mm256_sub_ps(y1, y0);
+
+        __m256 reject = _mm256_or_ps(
+            _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(x0, xmin, _CMP_LT_OQ), _mm256_cmp_ps(x1, xmin, _CMP_LT_OQ)),
+                         _mm256_and_ps(_mm256_cmp_ps(x0, xmax, _CMP_GT_OQ), _mm256_cmp_ps(x1, xmax, _CMP_GT_OQ))),
+            _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(y0, ymin, _CMP_LT_OQ), _mm256_cmp_ps(y1, ymin, _CMP_LT_OQ)),
+                         _mm256_and_ps(_mm256_cmp_ps(y0, ymax, _CMP_GT_OQ), _mm256_cmp_ps(y1, ymax, _CMP_GT_OQ))));
+        __m256 t0 = zero, t1 = one;
+        const __m256 p[4] = {_mm256_sub_ps(zero, dx), dx, _mm256_sub_ps(zero, dy), dy};
+        const __m256 q[4] = {_mm256_sub_ps(x0, xmin), _mm256_sub_ps(xmax, x0), _mm256_sub_ps(y0, ymin), _mm256_sub_ps(ymax, y0)};
+        for (int k = 0; k < 4; ++k) {
+            reject = _mm256_or_ps(reject, _mm256_and_ps(_mm256_cmp_ps(p[k], zero, _CMP_EQ_OQ), _mm256_cmp_ps(q[k], zero, _CMP_LT_OQ)));
+            const __m256 t = _mm256_div_ps(q[k], p[k]);
+            t0 = selectAVX2(_mm256_cmp_ps(p[k], zero, _CMP_LT_OQ), _mm256_max_ps(t0, t), t0);
+            t1 = selectAVX2(_mm256_cmp_ps(p[k], zero, _CMP_GT_OQ), _mm256_min_ps(t1, t), t1);
+        }
+        const __m256 accept = _mm256_andnot_ps(reject, _mm256_cmp_ps(t0, t1, _CMP_LE_OQ));
+
+        const __m256 move0 = _mm256_cmp_ps(t0, zero, _CMP_GT_OQ), move1 = _mm256_cmp_ps(t1, one, _CMP_LT_OQ);
+        const __m256 cx0 = selectAVX2(move0, _mm256_add_ps(x0, _mm256_mul_ps(dx, t0)), x0);
+        const __m256 cy0 = selectAVX2(move0, _mm256_add_ps(y0, _mm256_mul_ps(dy, t0)), y0);
+        const __m256 cx1 = selectAVX2(move1, _mm256_add_ps(x0, _mm256_mul_ps(dx, t1)), x1);
+        const __m256 cy1 = selectAVX2(move1, _mm256_add_ps(y0, _mm256_mul_ps(dy, t1)), y1);
+        _mm256_storeu_ps(&s.x0[i], cx0);
+        _mm256_storeu_ps(&s.y0[i], cy0);
+        _mm256_storeu_ps(&s.x1[i], cx1);
+        _mm256_storeu_ps(&s.y1[i], cy1);
+
+        const __m256 border = _mm256_or_ps(
+            _mm256_or_ps(_mm256_and_ps(nearAVX2(cx0, xmin, absMask, eps), nearAVX2(cx1, xmin, absMask, eps)),
+                         _mm256_and_ps(nearAVX2(cx0, xmax, absMask, eps), nearAVX2(cx1, xmax, absMask, eps))),
+            _mm256_or_ps(_mm256_and_ps(nearAVX2(cy0, ymin, absMask, eps), nearAVX2(cy1, ymin, absMask, eps)),
+                         _mm256_and_ps(nearAVX2(cy0, ymax, absMask, eps), nearAVX2(cy1, ymax, absMask, eps))));
+        const int acceptBits = _mm256_movemask_ps(accept), borderBits = _mm256_movemask_ps(border);
+        for (int j = 0; j < 8; ++j) {
+            s.segmentClass[i + j] = !((acceptBits >> j) & 1) ? SEGMENT_REJECTED
+                                  : ((borderBits >> j) & 1)  ? SEGMENT_BORDER
+                                                             : SEGMENT_VISIBLE;
+        }
+    }
+    clipScalar(s, vp, i, count);
+}
+
+#endif // CG_SEGMENT_CLIP_X86
+
+} // namespace
+
+void SegmentBatch::resize(size_t count) {
+    x0.resize(count);
+    y0.resize(count);
+    x1.resize(count);
+    y1.resize(count);
+    segmentClass.resize(count);
+}
+
+bool clipSegmentToViewport(glm::vec2& a, glm::vec2& b, const WA_Viewport& vp) {
+    const unsigned codeA = outcode(a, vp), codeB = outcode(b, vp);
+    if (!(codeA | codeB)) return true;
+    if (codeA & codeB) return false;
+
+    // Liang-Barsky
+    const glm::vec2 start = a;
+    const glm::vec2 d = b - a;
+    const float p[4] = {-d.x, d.x, -d.y, d.y};
+    const float q[4] = {a.x - vp.xmin, vp.xmax - a.x, a.y - vp.ymin, vp.ymax - a.y};
+    float t0 = 0.0f, t1 = 1.0f;
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0f) {
+            if (q[i] < 0.0f) return false; // Parallel to and outside this side
+            continue;
+        }
+        const float t = q[i] / p[i];
+        if (p[i] < 0.0f) {
+            if (t > t1) return false;
+            t0 = std::max(t0, t);
+        } else {
+            if (t < t0) return false;
+            t1 = std::min(t1, t);
+        }
+    }
+    if (t0 > 0.0f) a = start + d * t0;
+    if (t1 < 1.0f) b = start + d * t1;
+    return true;
+}
+
+bool onSameViewportSide(const glm::vec2& a, const glm::vec2& b, const WA_Viewport& vp) {
+    const float eps = kBorderEpsilon;
+    return (std::abs(a.x - vp.xmin) < eps && std::abs(b.x - vp.xmin) < eps) ||
+           (std::abs(a.x - vp.xmax) < eps && std::abs(b.x - vp.xmax) < eps) ||
+           (std::abs(a.y - vp.ymin) < eps && std::abs(b.y - vp.ymin) < eps) ||
+           (std::abs(a.y - vp.ymax) < eps && std::abs(b.y - vp.ymax) < eps);
+}
+
+SegmentClipKernel bestSegmentClipKernel() {
+#ifdef CG_SEGMENT_CLIP_X86
+    static const SegmentClipKernel best =
+        __builtin_cpu_supports("avx2") ? SegmentClipKernel::AVX2 : SegmentClipKernel::SSE;
+    return best;
+#else
+    return SegmentClipKernel::Scalar;
+#endif
+}
+
+const char* segmentClipKernelName(SegmentClipKernel kernel) {
+    switch (kernel) {
+        case SegmentClipKernel::Auto: return segmentClipKernelName(bestSegmentClipKernel());
+        case SegmentClipKernel::Scalar: return "scalar";
+        case SegmentClipKernel::SSE: return "SSE";
+        case SegmentClipKernel::AVX2: return "AVX2";
+    }
+    return "unknown";
+}
+
+void clipSegments(SegmentBatch& segments, const WA_Viewport& vp, SegmentClipKernel kernel) {
+    const size_t count = segments.size();
+    if (kernel == SegmentClipKernel::Auto) kernel = bestSegmentClipKernel();
+#ifdef CG_SEGMENT_CLIP_X86
+    if (kernel == SegmentClipKernel::AVX2 && bestSegmentClipKernel() == SegmentClipKernel::AVX2) {
+        clipAVX2(segments, vp, count);
+        return;
+    }
+    if (kernel == SegmentClipKernel::SSE || kernel == SegmentClipKernel::AVX2) {
+        clipSSE(segments, vp, count);
+        return;
+    }
+#endif
+    clipScalar(segments, vp, 0, count);
+}
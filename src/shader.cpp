@@ -91,3 +91,11 @@ void Shader::setVec4(const std::string& name, const glm::vec4& val) {
 void Shader::setVec2(const std::string& name, const glm::vec2& val) {
     glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, glm::value_ptr(val));
 }
+
+void Shader::setFloat(const std::string& name, float val) {
+    glUniform1f(glGetUniformLocation(ID, name.c_str()), val);
+}
+
+void Shader::setInt(const std::string& name, int val) {
+    glUniform1i(glGetUniformLocation(ID, name.c_str()), val);
+}
@@ -0,0 +1,217 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+#include "log.hpp"
+#include "stream_buffer.hpp"
+
+// GL 4.4 / ARB_buffer_storage, not part of the 3.3 loader
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace {
+
+typedef void (APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+BufferStorageProc bufferStorage = nullptr;
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+const GLbitfield kPersistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+} // namespace
+
+bool streamBufferPersistentSupported() {
+    static const bool supported = [] {
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        bool available = major > 4 || (major == 4 && minor >= 4);
+        GLint extensions = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+        for (GLint i = 0; i < extensions && !available; ++i) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            available = name && !std::strcmp(name, "GL_ARB_buffer_storage");
+        }
+        if (available) bufferStorage = reinterpret_cast<BufferStorageProc>(glfwGetProcAddress("glBufferStorage"));
+        return available && bufferStorage != nullptr;
+    }();
+    return supported;
+}
+
+bool StreamBuffer::init(size_t elementSize_, size_t regionElements_, Mode mode) {
+    destroy();
+    elementSize = elementSize_;
+    if (mode == Mode::Auto || mode == Mode::Persistent) {
+        activeMode = streamBufferPersistentSupported() ? Mode::Persistent : Mode::Orphaning;
+    } else {
+        activeMode = mode;
+    }
+    if (!allocate(std::max<size_t>(regionElements_, 1))) {
+        std::cerr << "Failed to allocate " << modeName() << " stream buffer" << std::endl;
+        return false;
+    }
+    LOG_INFO("Stream buffer: %s, %d x %zu bytes", modeName(), kRegions, regionElements * elementSize);
+    return true;
+}
+
+bool StreamBuffer::allocate(size_t elements) {
+    deleteFences();
+    if (id) {
+        if (mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, id);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            mapped = nullptr;
+        }
+        glDeleteBuffers(1, &id);
+    }
+    regionElements = elements;
+    nextRegion = 0;
+    region = 0;
+    cursor = 0;
+    frameOpen = false;
+
+    glGenBuffers(1, &id);
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    const GLsizeiptr bytes = static_cast<GLsizeiptr>(capacityBytes());
+    if (activeMode == Mode::Persistent) {
+        // Storage is immutable: growing means a new buffer, which the caller sees through buffer()
+        bufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, kPersistentFlags);
+        mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, kPersistentFlags);
+        if (!mapped) {
+            // Advertised but unusable: fall back for the lifetime of this buffer
+            glDeleteBuffers(1, &id);
+            activeMode = Mode::Orphaning;
+            glGenBuffers(1, &id);
+            glBindBuffer(GL_ARRAY_BUFFER, id);
+        }
+    }
+    if (activeMode != Mode::Persistent) glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return id != 0;
+}
+
+size_t StreamBuffer::upload(const void* data, size_t count) {
+    last = UploadStats();
+    const size_t bytes = count * elementSize;
+    last.bytes = bytes;
+    const size_t demand = (frameOpen ? cursor : 0) + count;
+    if (demand > regionElements) {
+        // Sized for the whole frame; the frame continues at the start of the new buffer
+        allocate(demand + demand / 2);
+        last.reallocated = true;
+    }
+    const auto start = Clock::now();
+
+    if (!frameOpen) {
+        region = activeMode == Mode::SubData ? 0 : nextRegion;
+        nextRegion = (nextRegion + 1) % kRegions;
+        cursor = 0;
+        frameOpen = true;
+        if (activeMode == Mode::Persistent && fences[region]) {
+            // The GPU may still be drawing from this region kRegions frames ago
+            while (glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {
+            }
+            glDeleteSync(fences[region]);
+            fences[region] = nullptr;
+        } else if (activeMode == Mode::Orphaning && region == 0) {
+            // Wrapping around: orphan the storage instead of waiting for the GPU, so the
+            // other regions can then be written unsynchronized
+            glBindBuffer(GL_ARRAY_BUFFER, id);
+            glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacityBytes()), nullptr, GL_STREAM_DRAW);
+        }
+    }
+    const size_t offset = (static_cast<size_t>(region) * regionElements + cursor) * elementSize;
+    cursor += count;
+
+    if (activeMode == Mode::Persistent) {
+        last.waitMs = millisecondsSince(start);
+        std::memcpy(static_cast<uint8_t*>(mapped) + offset, data, bytes);
+        return offset / elementSize;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, id);
+    if (activeMode == Mode::SubData) {
+        // Implicitly synchronizes with any draw still reading the buffer
+        glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), data);
+    } else {
+        void* dst = glMapBufferRange(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes),
+                                     GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        last.waitMs = millisecondsSince(start);
+        if (dst) {
+            std::memcpy(dst, data, bytes);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        } else {
+            glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(bytes), data);
+        }
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    return offset / elementSize;
+}
+
+void StreamBuffer::fence() {
+    if (!frameOpen) return;
+    frameOpen = false;
+    // Only persistent regions are written synchronized by hand; the other modes leave it to the driver
+    if (activeMode != Mode::Persistent) return;
+    if (fences[region]) glDeleteSync(fences[region]);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool StreamBuffer::resize(size_t regionElements_) {
+    if (!id) return false;
+    if (regionElements_ == regionElements) return true;
+    return allocate(std::max<size_t>(regionElements_, 1));
+}
+
+void StreamBuffer::deleteFences() {
+    for (GLsync& f : fences) {
+        if (f) glDeleteSync(f);
+        f = nullptr;
+    }
+}
+
+void StreamBuffer::destroy() {
+    deleteFences();
+    if (id) {
+        if (mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, id);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &id);
+    }
+    id = 0;
+    mapped = nullptr;
+    regionElements = 0;
+    nextRegion = 0;
+    region = 0;
+    cursor = 0;
+    frameOpen = false;
+}
+
+size_t StreamBuffer::capacityBytes() const {
+    const size_t regions = activeMode == Mode::SubData ? 1 : kRegions;
+    return regions * regionElements * elementSize;
+}
+
+const char* StreamBuffer::modeName() const {
+    switch (activeMode) {
+        case Mode::Auto: return "auto";
+        case Mode::Orphaning: return "orphaning";
+        case Mode::Persistent: return "persistent";
+        case Mode::SubData: return "glBufferSubData";
+    }
+    return "?";
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+
+#include "thread_pool.hpp"
+
+unsigned ThreadPool::resolveThreadCount(unsigned requested) {
+    if (requested > 0) return requested;
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    unsigned total = resolveThreadCount(threadCount);
+    for (unsigned i = 1; i < total; ++i) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& t : workers) t.join();
+}
+
+// Pull task indices until none are left
+void ThreadPool::drainTasks() {
+    while (true) {
+        size_t i = nextTask.fetch_add(1, std::memory_order_relaxed);
+        if (i >= jobTaskCount) break;
+        (*job)(i);
+    }
+}
+
+void ThreadPool::workerLoop() {
+    unsigned long long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeWorkers.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            ++busyWorkers;
+        }
+        drainTasks();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busyWorkers;
+        }
+        jobDone.notify_one();
+    }
+}
+
+void ThreadPool::run(size_t taskCount, const std::function<void(size_t)>& fn) {
+    if (taskCount == 0) return;
+    if (workers.empty() || taskCount == 1) {
+        for (size_t i = 0; i < taskCount; ++i) fn(i);
+        return;
+    }
+    {
+        // A worker that woke late for the previous job may still be draining it
+        std::unique_lock<std::mutex> lock(mutex);
+        jobDone.wait(lock, [&] { return busyWorkers == 0; });
+        job = &fn;
+        jobTaskCount = taskCount;
+        nextTask.store(0, std::memory_order_relaxed);
+        ++generation;
+    }
+    wakeWorkers.notify_all();
+    drainTasks();
+
+    // Workers that woke up for this generation may still be finishing a task
+    std::unique_lock<std::mutex> lock(mutex);
+    jobDone.wait(lock, [&] { return busyWorkers == 0; });
+    job = nullptr;
+}
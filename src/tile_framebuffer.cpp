@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "thread_pool.hpp"
+#include "tile_framebuffer.hpp"
+
+namespace {
+
+// Same cut-off as the point path: fainter pixels are not drawn
+const float kMinCoverage = 0.05f;
+
+// Run fn(tile) for every tile, on the pool when there is one
+template <class F>
+void forEachTile(ThreadPool* pool, int tileCount, F&& fn) {
+    if (pool && pool->size() > 1) {
+        pool->run(static_cast<size_t>(tileCount), [&](size_t t) { fn(static_cast<int>(t)); });
+    } else {
+        for (int t = 0; t < tileCount; ++t) fn(t);
+    }
+}
+
+} // namespace
+
+void TileFramebuffer::resize(int width, int height) {
+    imageWidth = std::max(width, 0);
+    imageHeight = std::max(height, 0);
+    tileColumns = (imageWidth + kTileSize - 1) / kTileSize;
+    tileRows = (imageHeight + kTileSize - 1) / kTileSize;
+    rgba.resize(static_cast<size_t>(imageWidth) * imageHeight * 4);
+    bins.resize(static_cast<size_t>(tileColumns) * tileRows);
+}
+
+void TileFramebuffer::clear(ThreadPool* pool) {
+    forEachTile(pool, tileColumns * tileRows, [&](int tile) {
+        const int x0 = (tile % tileColumns) * kTileSize;
+        const int y0 = (tile / tileColumns) * kTileSize;
+        const int x1 = std::min(x0 + kTileSize, imageWidth);
+        const int y1 = std::min(y0 + kTileSize, imageHeight);
+        for (int y = y0; y < y1; ++y) {
+            std::memset(&rgba[(static_cast<size_t>(y) * imageWidth + x0) * 4], 0, static_cast<size_t>(x1 - x0) * 4);
+        }
+    });
+}
+
+void TileFramebuffer::drawSegments(const std::vector<std::pair<glm::vec2, glm::vec2>>& segments,
+                                   const glm::vec4& color, ThreadPool* pool) {
+    if (segments.empty() || tileColumns == 0 || tileRows == 0) return;
+    binSegments(segments);
+    forEachTile(pool, tileColumns * tileRows, [&](int tile) {
+        if (!bins[tile].empty()) rasterizeTile(tile, segments, color);
+    });
+}
+
+// Add each segment to every tile whose (1 px padded) rectangle the line passes through
+void TileFramebuffer::binSegments(const std::vector<std::pair<glm::vec2, glm::vec2>>& segments) {
+    for (auto& bin : bins) bin.clear();
+    binTotal = 0;
+    const float half = 0.5f * kTileSize;
+    // A Wu pixel can sit up to ~1.5 px from the ideal line
+    const float reach = half * 1.41421356f + 2.0f;
+    for (size_t s = 0; s < segments.size(); ++s) {
+        const glm::vec2 a = segments[s].first, b = segments[s].second;
+        const int tx0 = std::max(0, static_cast<int>(std::floor((std::min(a.x, b.x) - 2.0f) / kTileSize)));
+        const int ty0 = std::max(0, static_cast<int>(std::floor((std::min(a.y, b.y) - 2.0f) / kTileSize)));
+        const int tx1 = std::min(tileColumns - 1, static_cast<int>(std::floor((std::max(a.x, b.x) + 2.0f) / kTileSize)));
+        const int ty1 = std::min(tileRows - 1, static_cast<int>(std::floor((std::max(a.y, b.y) + 2.0f) / kTileSize)));
+        const glm::vec2 d = b - a;
+        const float length = std::sqrt(d.x * d.x + d.y * d.y);
+        for (int ty = ty0; ty <= ty1; ++ty) {
+            for (int tx = tx0; tx <= tx1; ++tx) {
+                // Distance from the tile centre to the infinite line through the segment
+                if (length > 0.0f) {
+                    const glm::vec2 c(tx * kTileSize + half - a.x, ty * kTileSize + half - a.y);
+                    if (std::abs(d.x * c.y - d.y * c.x) > reach * length) continue;
+                }
+                bins[static_cast<size_t>(ty) * tileColumns + tx].push_back(static_cast<uint32_t>(s));
+                ++binTotal;
+            }
+        }
+    }
+}
+
+// Wu's algorithm restricted to the tile. Column x along the major axis
+// covers pixels floor(y) and floor(y) + 1 with y = y0 + gradient * (x - x0)
+// for x from round(x0) to round(x1), matching drawWuLine2D().
+void TileFramebuffer::rasterizeTile(int tile, const std::vector<std::pair<glm::vec2, glm::vec2>>& segments,
+                                    const glm::vec4& color) {
+    const int tileX0 = (tile % tileColumns) * kTileSize;
+    const int tileY0 = (tile / tileColumns) * kTileSize;
+    const int tileX1 = std::min(tileX0 + kTileSize, imageWidth);  // Exclusive
+    const int tileY1 = std::min(tileY0 + kTileSize, imageHeight); // Exclusive
+    const float rgb[3] = {color.r * 255.0f, color.g * 255.0f, color.b * 255.0f};
+
+    auto plot = [&](int x, int y, float coverage) {
+        if (coverage <= kMinCoverage || x < tileX0 || x >= tileX1 || y < tileY0 || y >= tileY1) return;
+        uint8_t* px = &rgba[(static_cast<size_t>(y) * imageWidth + x) * 4];
+        const float keep = 1.0f - coverage;
+        for (int c = 0; c < 3; ++c) px[c] = static_cast<uint8_t>(px[c] * keep + rgb[c] * coverage + 0.5f);
+        px[3] = static_cast<uint8_t>(px[3] * keep + 255.0f * coverage + 0.5f);
+    };
+
+    for (uint32_t s : bins[tile]) {
+        glm::vec2 p0 = segments[s].first, p1 = segments[s].second;
+        const bool steep = std::abs(p1.y - p0.y) > std::abs(p1.x - p0.x);
+        if (steep) {
+            std::swap(p0.x, p0.y);
+            std::swap(p1.x, p1.y);
+        }
+        if (p0.x > p1.x) std::swap(p0, p1);
+        const float dx = p1.x - p0.x;
+        const float gradient = (dx == 0.0f) ? 1.0f : (p1.y - p0.y) / dx;
+
+        // Major-axis range of the line, cut to the tile
+        const int majorMin = steep ? tileY0 : tileX0;
+        const int majorMax = (steep ? tileY1 : tileX1) - 1;
+        const int xFirst = std::max(static_cast<int>(std::round(p0.x)), majorMin);
+        const int xLast = std::min(static_cast<int>(std::round(p1.x)), majorMax);
+        for (int x = xFirst; x <= xLast; ++x) {
+            const double y = p0.y + static_cast<double>(gradient) * (x - p0.x);
+            const int iy = static_cast<int>(std::floor(y));
+            const float f = static_cast<float>(y - iy);
+            if (steep) {
+                plot(iy, x, 1.0f - f);
+                plot(iy + 1, x, f);
+            } else {
+                plot(x, iy, 1.0f - f);
+                plot(x, iy + 1, f);
+            }
+        }
+    }
+}
@@ -1,26 +1,13 @@
 // Weiler-Atherton polygon clipping algorithm implementation
-// This is a simplified version for convex viewport clipping
+// The viewport clippers are a simplified version for the convex rectangle;
+// WA_ClipRegion clipping is the full algorithm for arbitrary polygons
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 #include <glm/glm.hpp>
 
-
-// A point in 2D
-struct WA_Point {
-    float x, y;
-    WA_Point(float x_, float y_) : x(x_), y(y_) {}
-};
-// A polygon is a list of points
-using WA_Polygon = std::vector<WA_Point>;
-// The viewport is defined as a rectangle (xmin, ymin, xmax, ymax)
-struct WA_Viewport {
-    float xmin, ymin, xmax, ymax;
-};
-
-// Holds both the clipped polygon and the intersection segments on the viewport boundary
-struct WA_ClipResult {
-    WA_Polygon clipped;
-    std::vector<std::pair<WA_Point, WA_Point>> boundary_segments;
-};
+#include "weiler-atherton-clip.hpp"
 
 // Helper: check if point is inside the viewport
 static bool wa_inside(const WA_Point& p, const WA_Viewport& vp) {
@@ -120,3 +107,427 @@ WA_ClipResult weiler_atherton_clip(const WA_Polygon& poly, const WA_Viewport& vp
 
     return {out, boundary_segments};
 }
+
+namespace {
+
+enum : uint8_t { OUT_LEFT = 1, OUT_RIGHT = 2, OUT_TOP = 4, OUT_BOTTOM = 8 };
+
+// Sides of the viewport the point lies strictly beyond; the edges themselves count as inside
+inline uint8_t wa_outcode(const glm::vec2& p, const WA_Viewport& vp) {
+    return static_cast<uint8_t>((p.x < vp.xmin ? OUT_LEFT : 0) | (p.x > vp.xmax ? OUT_RIGHT : 0) |
+                                (p.y < vp.ymin ? OUT_TOP : 0) | (p.y > vp.ymax ? OUT_BOTTOM : 0));
+}
+
+// One Sutherland-Hodgman pass of wa_clip_edge() over raw arrays; returns the output size
+size_t wa_clip_edge_into(const glm::vec2* in, size_t n, glm::vec2* out, float edge, bool vertical, bool inside_less) {
+    auto inside = [&](const glm::vec2& p) {
+        const float v = vertical ? p.x : p.y;
+        return inside_less ? v >= edge : v <= edge;
+    };
+    auto intersect = [&](const glm::vec2& p1, const glm::vec2& p2) {
+        WA_Point q = wa_intersect(WA_Point(p1.x, p1.y), WA_Point(p2.x, p2.y), edge, vertical);
+        return glm::vec2(q.x, q.y);
+    };
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const glm::vec2& curr = in[i];
+        const glm::vec2& prev = in[(i + n - 1) % n];
+        const bool curr_in = inside(curr), prev_in = inside(prev);
+        if (curr_in) {
+            if (!prev_in) out[count++] = intersect(prev, curr);
+            out[count++] = curr;
+        } else if (prev_in) {
+            out[count++] = intersect(prev, curr);
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+void weiler_atherton_clip_faces(const FaceList& faces, const ProjectedVertices& screen, const WA_Viewport& vp,
+                                WA_ClippedPolygons& out, const SoAPositions* positions) {
+    // Clipping a convex face adds at most one vertex per side; concave faces can
+    // add more and grow the arrays below
+    const size_t faceCount = faces.size();
+    const size_t pointBound = faces.indices.size() + 4 * faceCount;
+    if (out.points.size() < pointBound) out.points.resize(pointBound);
+    if (out.offsets.size() < faceCount + 1) out.offsets.resize(faceCount + 1);
+    if (out.faces.size() < faceCount) out.faces.resize(faceCount);
+    out.polygonCount = 0;
+    out.trivialAccepts = 0;
+    out.trivialRejects = 0;
+    out.depthClips = 0;
+    out.offsets[0] = 0;
+
+    size_t written = 0;
+    auto room = [&](size_t count) {
+        if (written + count > out.points.size()) out.points.resize(std::max(2 * out.points.size(), written + count));
+        return out.points.data() + written;
+    };
+    for (size_t f = 0; f < faceCount; ++f) {
+        const int* face = faces.face(f);
+        size_t n = static_cast<size_t>(faces.faceSize(f));
+        uint8_t frustumAnd = 0xFF, frustumOr = 0;
+        for (size_t k = 0; k < n; ++k) {
+            frustumAnd &= screen.clipCodes[face[k]];
+            frustumOr |= screen.clipCodes[face[k]];
+        }
+        if (frustumAnd) {
+            ++out.trivialRejects;
+            continue;
+        }
+        // Faces crossing a depth plane continue as their clipped polygon
+        const glm::vec2* depthClipped = nullptr;
+        if (frustumOr & CLIP_DEPTH) {
+            if (!positions) continue;
+            n = clipFaceToFrustum(*positions, screen, face, n, out.depthClipped, out.depthScratch);
+            if (n == 0) continue;
+            depthClipped = out.depthClipped.data();
+            ++out.depthClips;
+        }
+        auto vertex = [&](size_t k) { return depthClipped ? depthClipped[k] : screen.screen[face[k]]; };
+
+        uint8_t codeAnd = 0xF, codeOr = 0;
+        for (size_t k = 0; k < n; ++k) {
+            const uint8_t code = wa_outcode(vertex(k), vp);
+            codeAnd &= code;
+            codeOr |= code;
+        }
+        if (codeAnd) {
+            ++out.trivialRejects;
+            continue;
+        }
+
+        size_t count = n;
+        if (!codeOr) {
+            ++out.trivialAccepts;
+            glm::vec2* dst = room(n);
+            for (size_t k = 0; k < n; ++k) dst[k] = vertex(k);
+        } else {
+            // Passes alternate between the two scratch halves; sides no vertex crosses are
+            // skipped. A pass adds at most one vertex per re-entry, half the input at worst.
+            const size_t half = 6 * n + 4;
+            if (out.scratch.size() < 2 * half) out.scratch.resize(2 * half);
+            glm::vec2* a = out.scratch.data();
+            glm::vec2* b = a + half;
+            for (size_t k = 0; k < n; ++k) a[k] = vertex(k);
+            if (codeOr & OUT_LEFT) { count = wa_clip_edge_into(a, count, b, vp.xmin, true, true); std::swap(a, b); }
+            if (codeOr & OUT_RIGHT) { count = wa_clip_edge_into(a, count, b, vp.xmax, true, false); std::swap(a, b); }
+            if (codeOr & OUT_TOP) { count = wa_clip_edge_into(a, count, b, vp.ymin, false, true); std::swap(a, b); }
+            if (codeOr & OUT_BOTTOM) { count = wa_clip_edge_into(a, count, b, vp.ymax, false, false); std::swap(a, b); }
+            if (count == 0) continue; // Crossed a corner region without entering the viewport
+            std::copy(a, a + count, room(count));
+        }
+
+        written += count;
+        out.faces[out.polygonCount] = static_cast<int>(f);
+        out.offsets[++out.polygonCount] = static_cast<int>(written);
+    }
+}
+
+static float wa_signed_area(const WA_Polygon& poly) {
+    float area = 0.0f;
+    for (size_t i = 0, n = poly.size(); i < n; ++i) {
+        const WA_Point& a = poly[i];
+        const WA_Point& b = poly[(i + 1) % n];
+        area += a.x * b.y - b.x * a.y;
+    }
+    return 0.5f * area;
+}
+
+// Even-odd test against all edges, for the (small) subject polygon
+static bool wa_polygon_contains(const WA_Polygon& poly, float x, float y) {
+    bool inside = false;
+    for (size_t i = 0, n = poly.size(); i < n; ++i) {
+        const WA_Point& a = poly[i];
+        const WA_Point& b = poly[(i + 1) % n];
+        if ((a.y > y) != (b.y > y) && x < a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)) inside = !inside;
+    }
+    return inside;
+}
+
+// Intersection of subject edge p + t*r with clip edge q + u*s; both ranges are
+// half-open [0, 1) so a crossing exactly at a shared vertex is counted once
+static bool wa_edge_intersection(const WA_Point& p, const WA_Point& p2, const WA_Point& q, const WA_Point& q2, float& t, float& u) {
+    const float rx = p2.x - p.x, ry = p2.y - p.y;
+    const float sx = q2.x - q.x, sy = q2.y - q.y;
+    const float denom = rx * sy - ry * sx;
+    if (denom == 0.0f) return false; // Parallel or collinear: no single crossing
+    const float qpx = q.x - p.x, qpy = q.y - p.y;
+    t = (qpx * sy - qpy * sx) / denom;
+    u = (qpx * ry - qpy * rx) / denom;
+    return t >= 0.0f && t < 1.0f && u >= 0.0f && u < 1.0f;
+}
+
+struct WA_Intersection {
+    int subjectEdge;
+    float t;
+    int clipEdge;
+    float u;
+    WA_Point point;
+    bool entry;
+};
+
+WA_ClipRegion::WA_ClipRegion(const WA_Polygon& boundary, int gridSize) : points(boundary) {
+    if (wa_signed_area(points) < 0.0f) std::reverse(points.begin(), points.end());
+    const int n = static_cast<int>(points.size());
+    if (n == 0) {
+        cellStart.assign(2, 0);
+        rowStart.assign(2, 0);
+        return;
+    }
+
+    minX = maxX = points[0].x;
+    minY = maxY = points[0].y;
+    for (const WA_Point& p : points) {
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+    }
+    if (gridSize <= 0) gridSize = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(n))));
+    cols = rows = std::max(1, std::min(gridSize, 256));
+    cellW = std::max(maxX - minX, 1e-6f) / cols;
+    cellH = std::max(maxY - minY, 1e-6f) / rows;
+
+    // Each edge goes into every cell (and band) its bounding box overlaps: count, then fill
+    auto edgeCells = [&](int e, int& c0, int& c1, int& r0, int& r1) {
+        const WA_Point& a = points[e];
+        const WA_Point& b = points[(e + 1) % n];
+        c0 = column(std::min(a.x, b.x));
+        c1 = column(std::max(a.x, b.x));
+        r0 = row(std::min(a.y, b.y));
+        r1 = row(std::max(a.y, b.y));
+    };
+    cellStart.assign(static_cast<size_t>(cols) * rows + 1, 0);
+    rowStart.assign(rows + 1, 0);
+    int c0, c1, r0, r1;
+    for (int e = 0; e < n; ++e) {
+        edgeCells(e, c0, c1, r0, r1);
+        for (int r = r0; r <= r1; ++r) {
+            ++rowStart[r + 1];
+            for (int c = c0; c <= c1; ++c) ++cellStart[r * cols + c + 1];
+        }
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) cellStart[c] += cellStart[c - 1];
+    for (size_t r = 1; r < rowStart.size(); ++r) rowStart[r] += rowStart[r - 1];
+    cellEdges.resize(cellStart.back());
+    rowEdges.resize(rowStart.back());
+    std::vector<int> cellFill(cellStart.begin(), cellStart.end() - 1);
+    std::vector<int> rowFill(rowStart.begin(), rowStart.end() - 1);
+    for (int e = 0; e < n; ++e) {
+        edgeCells(e, c0, c1, r0, r1);
+        for (int r = r0; r <= r1; ++r) {
+            rowEdges[rowFill[r]++] = e;
+            for (int c = c0; c <= c1; ++c) cellEdges[cellFill[r * cols + c]++] = e;
+        }
+    }
+}
+
+int WA_ClipRegion::column(float x) const {
+    return std::max(0, std::min(cols - 1, static_cast<int>((x - minX) / cellW)));
+}
+
+int WA_ClipRegion::row(float y) const {
+    return std::max(0, std::min(rows - 1, static_cast<int>((y - minY) / cellH)));
+}
+
+void WA_ClipRegion::edgesNear(float x0, float y0, float x1, float y1, std::vector<int>& out) const {
+    if (points.empty() || x1 < minX || x0 > maxX || y1 < minY || y0 > maxY) return;
+    const size_t base = out.size();
+    const int c0 = column(x0), c1 = column(x1), r0 = row(y0), r1 = row(y1);
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const int cell = r * cols + c;
+            out.insert(out.end(), cellEdges.begin() + cellStart[cell], cellEdges.begin() + cellStart[cell + 1]);
+        }
+    }
+    std::sort(out.begin() + base, out.end());
+    out.erase(std::unique(out.begin() + base, out.end()), out.end());
+}
+
+bool WA_ClipRegion::contains(float x, float y) const {
+    if (points.empty() || x < minX || x > maxX || y < minY || y > maxY) return false;
+    // Cast a ray towards +x: only edges overlapping this point's band can cross it
+    const int r = row(y);
+    const size_t n = points.size();
+    bool inside = false;
+    for (int i = rowStart[r]; i < rowStart[r + 1]; ++i) {
+        const WA_Point& a = points[rowEdges[i]];
+        const WA_Point& b = points[(rowEdges[i] + 1) % n];
+        if ((a.y > y) != (b.y > y) && x < a.x + (y - a.y) * (b.x - a.x) / (b.y - a.y)) inside = !inside;
+    }
+    return inside;
+}
+
+std::vector<WA_Polygon> weiler_atherton_clip(const WA_Polygon& subjectIn, const WA_ClipRegion& clip) {
+    std::vector<WA_Polygon> pieces;
+    const WA_Polygon& clipPoly = clip.boundary();
+    if (subjectIn.size() < 3 || clipPoly.size() < 3) return pieces;
+    WA_Polygon subject = subjectIn;
+    if (wa_signed_area(subject) < 0.0f) std::reverse(subject.begin(), subject.end());
+    const int n = static_cast<int>(subject.size());
+    const int m = static_cast<int>(clipPoly.size());
+
+    // 1. Every crossing between a subject edge and a nearby clip edge
+    std::vector<WA_Intersection> ix;
+    std::vector<int> candidates;
+    for (int i = 0; i < n; ++i) {
+        const WA_Point& p = subject[i];
+        const WA_Point& p2 = subject[(i + 1) % n];
+        candidates.clear();
+        clip.edgesNear(std::min(p.x, p2.x), std::min(p.y, p2.y), std::max(p.x, p2.x), std::max(p.y, p2.y), candidates);
+        for (int e : candidates) {
+            float t, u;
+            if (wa_edge_intersection(p, p2, clipPoly[e], clipPoly[(e + 1) % m], t, u)) {
+                ix.push_back({i, t, e, u, WA_Point(p.x + (p2.x - p.x) * t, p.y + (p2.y - p.y) * t), false});
+            }
+        }
+    }
+
+    // 2. Order along each boundary. subjectOrder/clipOrder list the intersections
+    // in the order the subject/clip boundary visits them.
+    const int k = static_cast<int>(ix.size());
+    std::vector<int> subjectOrder(k), clipOrder(k);
+    for (int j = 0; j < k; ++j) subjectOrder[j] = clipOrder[j] = j;
+    std::sort(subjectOrder.begin(), subjectOrder.end(), [&](int a, int b) {
+        return ix[a].subjectEdge != ix[b].subjectEdge ? ix[a].subjectEdge < ix[b].subjectEdge : ix[a].t < ix[b].t;
+    });
+    std::sort(clipOrder.begin(), clipOrder.end(), [&](int a, int b) {
+        return ix[a].clipEdge != ix[b].clipEdge ? ix[a].clipEdge < ix[b].clipEdge : ix[a].u < ix[b].u;
+    });
+    std::vector<int> subjectPos(k), clipPos(k);
+    for (int j = 0; j < k; ++j) {
+        subjectPos[subjectOrder[j]] = j;
+        clipPos[clipOrder[j]] = j;
+    }
+
+    // 3. Entry/exit: crossings alternate along the subject. The starting state is
+    // taken at the midpoint of the longest stretch of subject boundary between
+    // crossings, which cannot sit on the clip boundary (a vertex can: meshes
+    // share vertices with lasso points drawn on them)
+    float longest = -1.0f;
+    WA_Point probe(0.0f, 0.0f);
+    int crossingsBefore = 0;
+    for (int i = 0, j = 0; i < n; ++i) {
+        const WA_Point& p = subject[i];
+        const WA_Point& p2 = subject[(i + 1) % n];
+        const float length = std::sqrt((p2.x - p.x) * (p2.x - p.x) + (p2.y - p.y) * (p2.y - p.y));
+        float from = 0.0f;
+        for (;; ++j) {
+            const bool last = j == k || ix[subjectOrder[j]].subjectEdge != i;
+            const float to = last ? 1.0f : ix[subjectOrder[j]].t;
+            if ((to - from) * length > longest) {
+                longest = (to - from) * length;
+                const float mid = 0.5f * (from + to);
+                probe = WA_Point(p.x + (p2.x - p.x) * mid, p.y + (p2.y - p.y) * mid);
+                crossingsBefore = j;
+            }
+            if (last) break;
+            from = to;
+        }
+    }
+    bool inside = clip.contains(probe.x, probe.y) != (crossingsBefore % 2 == 1);
+
+    // No crossings: one polygon lies inside the other, or they are disjoint
+    if (k == 0) {
+        if (inside) pieces.push_back(subject);
+        else if (wa_polygon_contains(subject, clipPoly[0].x, clipPoly[0].y)) pieces.push_back(clipPoly);
+        return pieces;
+    }
+    for (int j = 0; j < k; ++j) {
+        ix[subjectOrder[j]].entry = !inside;
+        inside = !inside;
+    }
+
+    // Boundary vertices strictly between two consecutive intersections, appended to out
+    auto appendBetween = [](const WA_Polygon& poly, int fromEdge, int toEdge, bool wrap, WA_Polygon& out) {
+        const int size = static_cast<int>(poly.size());
+        if (fromEdge == toEdge && !wrap) return;
+        int v = (fromEdge + 1) % size;
+        const int stop = (toEdge + 1) % size;
+        do {
+            out.push_back(poly[v]);
+            v = (v + 1) % size;
+        } while (v != stop);
+    };
+
+    // 4. Trace: from an entry follow the subject to the next exit, from an exit
+    // follow the clip boundary to the next entry, until back at the start
+    std::vector<char> visited(k, 0);
+    for (int j = 0; j < k; ++j) {
+        const int start = subjectOrder[j];
+        if (!ix[start].entry || visited[start]) continue;
+        WA_Polygon piece;
+        int cur = start;
+        bool onSubject = true;
+        int guard = 0;
+        do {
+            visited[cur] = 1;
+            piece.push_back(ix[cur].point);
+            int next;
+            if (onSubject) {
+                next = subjectOrder[(subjectPos[cur] + 1) % k];
+                // Same edge and further along: no vertex in between; otherwise walk the subject
+                const bool wrap = ix[next].subjectEdge == ix[cur].subjectEdge && ix[next].t <= ix[cur].t;
+                appendBetween(subject, ix[cur].subjectEdge, ix[next].subjectEdge, wrap, piece);
+            } else {
+                next = clipOrder[(clipPos[cur] + 1) % k];
+                const bool wrap = ix[next].clipEdge == ix[cur].clipEdge && ix[next].u <= ix[cur].u;
+                appendBetween(clipPoly, ix[cur].clipEdge, ix[next].clipEdge, wrap, piece);
+            }
+            cur = next;
+            onSubject = !onSubject;
+        } while (cur != start && ++guard <= 2 * k);
+        // A broken alternation (degenerate input touching a vertex) would not close; drop it
+        if (cur == start && piece.size() >= 3) pieces.push_back(std::move(piece));
+    }
+    return pieces;
+}
+
+void weiler_atherton_clip_segment(const WA_Point& a, const WA_Point& b, const WA_ClipRegion& clip,
+                                  std::vector<std::pair<WA_Point, WA_Point>>& pieces) {
+    WA_SegmentScratch scratch;
+    weiler_atherton_clip_segment(a, b, clip, pieces, scratch);
+}
+
+void weiler_atherton_clip_segment(const WA_Point& a, const WA_Point& b, const WA_ClipRegion& clip,
+                                  std::vector<std::pair<WA_Point, WA_Point>>& pieces, WA_SegmentScratch& scratch) {
+    const WA_Polygon& clipPoly = clip.boundary();
+    const int m = static_cast<int>(clipPoly.size());
+    if (m < 3) return;
+    std::vector<int>& candidates = scratch.candidates;
+    candidates.clear();
+    clip.edgesNear(std::min(a.x, b.x), std::min(a.y, b.y), std::max(a.x, b.x), std::max(a.y, b.y), candidates);
+    std::vector<float>& ts = scratch.crossings;
+    ts.clear();
+    for (int e : candidates) {
+        float t, u;
+        if (wa_edge_intersection(a, b, clipPoly[e], clipPoly[(e + 1) % m], t, u)) ts.push_back(t);
+    }
+    std::sort(ts.begin(), ts.end());
+    ts.push_back(1.0f);
+
+    // Inside and outside alternate at every crossing; as for polygons, the state is
+    // probed in the middle of the longest stretch rather than at an end point
+    auto at = [&](float t) { return WA_Point(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t); };
+    float from = 0.0f, longest = -1.0f, probeT = 0.5f;
+    size_t crossingsBefore = 0;
+    for (size_t j = 0; j < ts.size(); ++j) {
+        if (ts[j] - from > longest) {
+            longest = ts[j] - from;
+            probeT = 0.5f * (from + ts[j]);
+            crossingsBefore = j;
+        }
+        from = ts[j];
+    }
+    const WA_Point probe = at(probeT);
+    bool inside = clip.contains(probe.x, probe.y) != (crossingsBefore % 2 == 1);
+    from = 0.0f;
+    for (float t : ts) {
+        if (inside && t > from) pieces.emplace_back(at(from), at(t));
+        inside = !inside;
+        from = t;
+    }
+}
@@ -5,67 +5,86 @@
 
 #include "xiaolin_wu.hpp"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 std::vector<Pixel> drawWuLine2D(glm::vec2 p0, glm::vec2 p1) {
     std::vector<Pixel> pixels;
-    bool steep = std::abs(p1.y - p0.y) > std::abs(p1.x - p0.x);
+    pixels.reserve(wuLinePixelCount(p0, p1));
+    rasterizeWuLine(p0, p1, [&](int x, int y, double intensity) { pixels.push_back({x, y, intensity}); });
+    return pixels;
+}
 
+void drawWuLine2DFixed(glm::vec2 p0, glm::vec2 p1, WuColumns8& out, bool vectorized) {
+    const bool steep = std::abs(p1.y - p0.y) > std::abs(p1.x - p0.x);
     if (steep) {
         std::swap(p0.x, p0.y);
         std::swap(p1.x, p1.y);
     }
-
-    // Left to right
     if (p0.x > p1.x) {
         std::swap(p0, p1);
     }
 
-    float dx = p1.x - p0.x;
-    float dy = p1.y - p0.y;
-    float gradient = (dx == 0.0f) ? 1.0f : dy / dx;
+    const float dx = p1.x - p0.x;
+    const float gradient = (dx == 0.0f) ? 1.0f : (p1.y - p0.y) / dx;
+    const int x_start = static_cast<int>(std::round(p0.x));
+    const int x_end = static_cast<int>(std::round(p1.x));
+    const size_t count = static_cast<size_t>(x_end - x_start + 1);
 
-    // First endpoint
-    int x_start = round(p0.x);
-    double y_start = p0.y + gradient * (x_start - p0.x);
-    
-    int x_start_px = x_start;
-    int y_start_px = floor(y_start);
+    // 16.16 minor coordinate at the first column and per-column step
+    const int32_t y_start = static_cast<int32_t>(std::lround((p0.y + gradient * (x_start - p0.x)) * 65536.0));
+    const int32_t step = static_cast<int32_t>(std::lround(gradient * 65536.0));
 
-    if (steep) {
-        pixels.push_back({y_start_px,     x_start_px, rfpart(y_start)});
-        pixels.push_back({y_start_px + 1, x_start_px,  fpart(y_start)});
-    } else {
-        pixels.push_back({x_start_px, y_start_px,     rfpart(y_start)});
-        pixels.push_back({x_start_px, y_start_px + 1,  fpart(y_start)});
-    }
-    
-    // Main loop
-    int x_end = round(p1.x);
-    double y = y_start + gradient; // First y-position after the starting endpoint
+    out.steep = steep;
+    out.first = x_start;
+    out.minor.resize(count);
+    out.upper.resize(count);
+    out.lower.resize(count);
 
-    for (int x = x_start + 1; x < x_end; ++x) {
-        int ix = floor(y);
-        if (steep) {
-            pixels.push_back({ix,     x, rfpart(y)});
-            pixels.push_back({ix + 1, x,  fpart(y)});
-        } else {
-            pixels.push_back({x, ix,     rfpart(y)});
-            pixels.push_back({x, ix + 1,  fpart(y)});
+    size_t i = 0;
+#if defined(__SSE2__)
+    if (vectorized) {
+        const __m128i byteMask = _mm_set1_epi32(0xFF);
+        const __m128i full = _mm_set1_epi8(static_cast<char>(0xFF));
+        const __m128i stride = _mm_set1_epi32(4 * step);
+        __m128i y = _mm_add_epi32(_mm_set1_epi32(y_start), _mm_setr_epi32(0, step, 2 * step, 3 * step));
+        for (; i + 8 <= count; i += 8) {
+            const __m128i y_next = _mm_add_epi32(y, stride);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&out.minor[i]), _mm_srai_epi32(y, 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&out.minor[i + 4]), _mm_srai_epi32(y_next, 16));
+            // Top 8 fraction bits of 8 columns, narrowed to bytes
+            const __m128i f16 = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(y, 8), byteMask),
+                                                _mm_and_si128(_mm_srli_epi32(y_next, 8), byteMask));
+            const __m128i f8 = _mm_packus_epi16(f16, f16);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&out.lower[i]), f8);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(&out.upper[i]), _mm_sub_epi8(full, f8));
+            y = _mm_add_epi32(y_next, stride);
         }
-        y += gradient;
     }
-
-    // Last endpoint
-    double y_end = p1.y + gradient * (x_end - p1.x);
-    int x_end_px = x_end;
-    int y_end_px = floor(y_end);
-
-    if (steep) {
-        pixels.push_back({y_end_px,     x_end_px, rfpart(y_end)});
-        pixels.push_back({y_end_px + 1, x_end_px,  fpart(y_end)});
-    } else {
-        pixels.push_back({x_end_px, y_end_px,     rfpart(y_end)});
-        pixels.push_back({x_end_px, y_end_px + 1,  fpart(y_end)});
+#else
+    (void)vectorized;
+#endif
+    for (; i < count; ++i) {
+        const int32_t y = y_start + static_cast<int32_t>(i) * step;
+        const uint8_t f = static_cast<uint8_t>((y >> 8) & 0xFF);
+        out.minor[i] = y >> 16;
+        out.lower[i] = f;
+        out.upper[i] = static_cast<uint8_t>(255 - f);
     }
+}
 
-    return pixels;
-}
\ No newline at end of file
+void appendWuPixels(const WuColumns8& columns, std::vector<Pixel>& out) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        const int major = columns.first + static_cast<int>(i);
+        const int minor = columns.minor[i];
+        const double upper = columns.upper[i] / 255.0, lower = columns.lower[i] / 255.0;
+        if (columns.steep) {
+            out.push_back({minor, major, upper});
+            out.push_back({minor + 1, major, lower});
+        } else {
+            out.push_back({major, minor, upper});
+            out.push_back({major, minor + 1, lower});
+        }
+    }
+}